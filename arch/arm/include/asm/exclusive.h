@@ -0,0 +1,65 @@
+/**
+ * @file exclusive.h
+ * @author Zhiyelah
+ * @brief 独占访问指令(LDREX/STREX)
+ * @note 仅ARMv7-M(Cortex-M3/M4/M7)支持; 异常进入和返回时硬件会清除本地独占监视器,
+ *       因此在单核上被中断打断的"加载-存储"序列必然存储失败并重试, 不存在ABA问题
+ */
+
+#ifndef _ZHIYEC_EXCLUSIVE_H
+#define _ZHIYEC_EXCLUSIVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <zhiyec/compiler.h>
+
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || \
+    defined(__TARGET_ARCH_7_M) || defined(__TARGET_ARCH_7E_M)
+#define ARCH_HAS_EXCLUSIVE_ACCESS 1
+#else
+#define ARCH_HAS_EXCLUSIVE_ACCESS 0
+#endif
+
+#if (ARCH_HAS_EXCLUSIVE_ACCESS)
+
+#if defined(__ARMCC_VERSION)
+
+/**
+ * @brief 独占加载
+ */
+#define exclusive_load(addr) ((uint32_t)__ldrex((volatile uint32_t *)(addr)))
+
+/**
+ * @brief 独占存储
+ * @return 是否存储成功
+ */
+#define exclusive_store(addr, value) (__strex((uint32_t)(value), (volatile uint32_t *)(addr)) == 0U)
+
+/**
+ * @brief 清除独占监视器
+ */
+#define exclusive_clear() __clrex()
+
+#else
+
+static always_inline uint32_t exclusive_load(volatile uint32_t *const addr) {
+    uint32_t value;
+    __asm__ volatile("ldrex %0, [%1]" : "=r"(value) : "r"(addr) : "memory");
+    return value;
+}
+
+static always_inline bool exclusive_store(volatile uint32_t *const addr, const uint32_t value) {
+    uint32_t result;
+    __asm__ volatile("strex %0, %2, [%1]" : "=&r"(result) : "r"(addr), "r"(value) : "memory");
+    return result == 0U;
+}
+
+static always_inline void exclusive_clear(void) {
+    __asm__ volatile("clrex" ::: "memory");
+}
+
+#endif
+
+#endif /* ARCH_HAS_EXCLUSIVE_ACCESS */
+
+#endif /* _ZHIYEC_EXCLUSIVE_H */
@@ -0,0 +1,97 @@
+/**
+ * @file simd.h
+ * @author Zhiyelah
+ * @brief DSP扩展的16位SIMD指令
+ * @note 仅带DSP扩展的ARMv7E-M(Cortex-M4/M7)支持; 一个32位寄存器保存两个有符号16位数,
+ *       低16位为第一个数(bottom), 高16位为第二个数(top)
+ */
+
+#ifndef _ZHIYEC_SIMD_H
+#define _ZHIYEC_SIMD_H
+
+#include <stdint.h>
+#include <zhiyec/compiler.h>
+
+#if defined(__ARM_FEATURE_DSP) || defined(__TARGET_FEATURE_DSPMUL)
+#define ARCH_HAS_DSP_SIMD 1
+#else
+#define ARCH_HAS_DSP_SIMD 0
+#endif
+
+#if (ARCH_HAS_DSP_SIMD)
+
+#if defined(__ARMCC_VERSION)
+
+/**
+ * @brief 两个16位数分别饱和相减
+ */
+#define simd_qsub16(a, b) ((uint32_t)__qsub16((a), (b)))
+
+/**
+ * @brief 双16位乘法后相减: a.bottom * b.bottom - a.top * b.top
+ */
+#define simd_smusd(a, b) ((int32_t)__smusd((a), (b)))
+
+/**
+ * @brief 低16位相乘
+ */
+#define simd_smulbb(a, b) ((int32_t)__smulbb((a), (b)))
+
+/**
+ * @brief 高16位相乘
+ */
+#define simd_smultt(a, b) ((int32_t)__smultt((a), (b)))
+
+/**
+ * @brief 组合a的低16位和b的低16位: b.bottom : a.bottom
+ */
+#define simd_pack_bottom(a, b) ((uint32_t)__pkhbt((a), (b), 16))
+
+/**
+ * @brief 组合a的高16位和b的高16位: b.top : a.top
+ */
+#define simd_pack_top(a, b) ((uint32_t)__pkhtb((b), (a), 16))
+
+#else
+
+static always_inline uint32_t simd_qsub16(const uint32_t a, const uint32_t b) {
+    uint32_t result;
+    __asm__("qsub16 %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+}
+
+static always_inline int32_t simd_smusd(const uint32_t a, const uint32_t b) {
+    int32_t result;
+    __asm__("smusd %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+}
+
+static always_inline int32_t simd_smulbb(const uint32_t a, const uint32_t b) {
+    int32_t result;
+    __asm__("smulbb %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+}
+
+static always_inline int32_t simd_smultt(const uint32_t a, const uint32_t b) {
+    int32_t result;
+    __asm__("smultt %0, %1, %2" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+}
+
+static always_inline uint32_t simd_pack_bottom(const uint32_t a, const uint32_t b) {
+    uint32_t result;
+    __asm__("pkhbt %0, %1, %2, lsl #16" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+}
+
+static always_inline uint32_t simd_pack_top(const uint32_t a, const uint32_t b) {
+    uint32_t result;
+    __asm__("pkhtb %0, %2, %1, asr #16" : "=r"(result) : "r"(a), "r"(b));
+    return result;
+}
+
+#endif
+
+#endif /* ARCH_HAS_DSP_SIMD */
+
+#endif /* _ZHIYEC_SIMD_H */
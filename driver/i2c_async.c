@@ -0,0 +1,378 @@
+#include <asm/irq.h>
+#include <driver/i2c_async.h>
+#include <utility/delay.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/event_flags.h>
+#include <zhiyec/kernel.h>
+
+#define HIGH_LEVEL 0x01
+#define LOW_LEVEL 0x00
+
+/* 阻塞传输完成的事件位 */
+#define I2C_ASYNC_EVENT_DONE 0x01U
+
+/* 状态机状态, 每个状态只操作一次引脚 */
+enum i2c_async_state {
+    STATE_IDLE = 0U,
+
+    /* 起始信号(也用于重复起始) */
+    STATE_START_SDA_HIGH,
+    STATE_START_SCL_HIGH,
+    STATE_START_SDA_LOW,
+    STATE_START_SCL_LOW,
+
+    /* 发送一位 */
+    STATE_TX_BIT_SDA,
+    STATE_TX_BIT_SCL_HIGH,
+    STATE_TX_BIT_SCL_LOW,
+
+    /* 等待从设备应答 */
+    STATE_TX_ACK_RELEASE,
+    STATE_TX_ACK_SCL_HIGH,
+    STATE_TX_ACK_READ,
+    STATE_TX_ACK_SCL_LOW,
+    STATE_TX_NACK_SCL_LOW,
+
+    /* 接收一位 */
+    STATE_RX_RELEASE,
+    STATE_RX_BIT_SCL_HIGH,
+    STATE_RX_BIT_READ,
+    STATE_RX_BIT_SCL_LOW,
+
+    /* 发送应答或非应答 */
+    STATE_RX_ACK_SDA,
+    STATE_RX_ACK_SCL_HIGH,
+    STATE_RX_ACK_SCL_LOW,
+
+    /* 停止信号(进入时SCL为低电平) */
+    STATE_STOP_SDA_LOW,
+    STATE_STOP_SCL_HIGH,
+    STATE_STOP_SDA_HIGH,
+};
+
+/* 传输阶段 */
+enum i2c_async_phase {
+    PHASE_ADDR_WRITE = 0U,
+    PHASE_REG,
+    PHASE_ADDR_READ,
+    PHASE_DATA_WRITE,
+    PHASE_DATA_READ,
+};
+
+/* 初始化总线 */
+void i2c_async_init(struct i2c_async *const bus, i2c_software_interface *const interface,
+                    const uint32_t ack_timeout_steps) {
+    assert(bus != NULL);
+    assert(interface != NULL);
+
+    bus->interface = interface;
+    bus->ack_timeout_steps = ack_timeout_steps;
+    queue_list_init(bus->requests);
+    bus->current = NULL;
+    bus->state = STATE_IDLE;
+}
+
+/* 提交传输请求 */
+void i2c_async_submit(struct i2c_async *const bus, struct i2c_async_request *const request) {
+    assert(bus != NULL);
+    assert(request != NULL);
+    assert(request->len == 0U || request->data != NULL);
+
+    request->status = I2C_ASYNC_PENDING;
+
+    atomic({
+        queue_list_push(bus->requests, &(request->node));
+    });
+}
+
+/* 取出下一个请求并开始传输, 返回是否有请求 */
+static bool i2c_async_start_next(struct i2c_async *const bus) {
+    struct i2c_async_request *request = NULL;
+
+    const uint32_t prev_basepri = irq_disable_from_isr();
+
+    if (!queue_list_is_empty(bus->requests)) {
+        request = container_of(queue_list_front(bus->requests), struct i2c_async_request, node);
+        queue_list_pop(bus->requests);
+    }
+
+    irq_enable_from_isr(prev_basepri);
+
+    if (request == NULL) {
+        return false;
+    }
+
+    request->status = I2C_ASYNC_BUSY;
+    bus->current = request;
+
+    /* 没有寄存器的读操作直接以读模式寻址 */
+    bus->phase = (request->is_read && !request->has_reg) ? PHASE_ADDR_READ : PHASE_ADDR_WRITE;
+    bus->state = STATE_START_SDA_HIGH;
+
+    return true;
+}
+
+/* 结束当前请求并通知调用者 */
+static void i2c_async_complete(struct i2c_async *const bus) {
+    struct i2c_async_request *const request = bus->current;
+
+    bus->current = NULL;
+    bus->state = STATE_IDLE;
+
+    if (request->complete != NULL) {
+        request->complete(request);
+    }
+
+    if (request->event_flags != NULL) {
+        (void)eventflags_set_from_isr(request->event_flags, request->event_mask);
+    }
+}
+
+/* 开始发送一个字节 */
+static inline void i2c_async_send_byte(struct i2c_async *const bus, const uint8_t byte) {
+    bus->byte = byte;
+    bus->bit_count = 8U;
+    bus->state = STATE_TX_BIT_SDA;
+}
+
+/* 开始接收一个字节 */
+static inline void i2c_async_receive_byte(struct i2c_async *const bus) {
+    bus->byte = 0U;
+    bus->bit_count = 8U;
+    bus->state = STATE_RX_RELEASE;
+}
+
+/* 结束传输并发送停止信号 */
+static inline void i2c_async_stop(struct i2c_async *const bus, const enum i2c_async_status status) {
+    bus->current->status = status;
+    bus->state = STATE_STOP_SDA_LOW;
+}
+
+/* 字节发送完成并收到应答, 决定下一步操作 */
+static void i2c_async_next_byte(struct i2c_async *const bus) {
+    const struct i2c_async_request *const request = bus->current;
+
+    switch (bus->phase) {
+    case PHASE_ADDR_WRITE:
+        if (request->has_reg) {
+            bus->phase = PHASE_REG;
+            i2c_async_send_byte(bus, request->reg_addr);
+            return;
+        }
+        /* fallthrough */
+
+    case PHASE_REG:
+        if (request->is_read) {
+            /* 重新开始, 以读模式寻址 */
+            bus->phase = PHASE_ADDR_READ;
+            bus->state = STATE_START_SDA_HIGH;
+            return;
+        }
+
+        bus->phase = PHASE_DATA_WRITE;
+        bus->index = 0U;
+        /* fallthrough */
+
+    case PHASE_DATA_WRITE:
+        if (bus->index < request->len) {
+            i2c_async_send_byte(bus, request->data[bus->index++]);
+        } else {
+            i2c_async_stop(bus, I2C_ASYNC_DONE);
+        }
+        return;
+
+    case PHASE_ADDR_READ:
+        bus->phase = PHASE_DATA_READ;
+        bus->index = 0U;
+
+        if (request->len > 0U) {
+            i2c_async_receive_byte(bus);
+        } else {
+            i2c_async_stop(bus, I2C_ASYNC_DONE);
+        }
+        return;
+
+    default:
+        return;
+    }
+}
+
+/* 推进一步传输 */
+bool i2c_async_step(struct i2c_async *const bus) {
+    assert(bus != NULL);
+
+    i2c_software_interface *const interface = bus->interface;
+    struct i2c_async_request *const request = bus->current;
+
+    switch ((enum i2c_async_state)bus->state) {
+    case STATE_IDLE:
+        return i2c_async_start_next(bus);
+
+    /* 起始信号 */
+    case STATE_START_SDA_HIGH:
+        interface->write_sda(HIGH_LEVEL);
+        bus->state = STATE_START_SCL_HIGH;
+        break;
+
+    case STATE_START_SCL_HIGH:
+        interface->write_scl(HIGH_LEVEL);
+        bus->state = STATE_START_SDA_LOW;
+        break;
+
+    case STATE_START_SDA_LOW:
+        interface->write_sda(LOW_LEVEL);
+        bus->state = STATE_START_SCL_LOW;
+        break;
+
+    case STATE_START_SCL_LOW:
+        interface->write_scl(LOW_LEVEL);
+        if (bus->phase == PHASE_ADDR_READ) {
+            i2c_async_send_byte(bus, (uint8_t)((request->dev_addr << 1) | 0x01));
+        } else {
+            i2c_async_send_byte(bus, (uint8_t)(request->dev_addr << 1));
+        }
+        break;
+
+    /* 发送一位 */
+    case STATE_TX_BIT_SDA:
+        interface->write_sda((bus->byte & 0x80) ? HIGH_LEVEL : LOW_LEVEL);
+        bus->byte <<= 1;
+        bus->state = STATE_TX_BIT_SCL_HIGH;
+        break;
+
+    case STATE_TX_BIT_SCL_HIGH:
+        interface->write_scl(HIGH_LEVEL);
+        bus->state = STATE_TX_BIT_SCL_LOW;
+        break;
+
+    case STATE_TX_BIT_SCL_LOW:
+        interface->write_scl(LOW_LEVEL);
+        bus->state = (--bus->bit_count > 0U) ? STATE_TX_BIT_SDA : STATE_TX_ACK_RELEASE;
+        break;
+
+    /* 等待应答 */
+    case STATE_TX_ACK_RELEASE:
+        interface->write_sda(HIGH_LEVEL);
+        bus->ack_wait_steps = 0U;
+        bus->state = STATE_TX_ACK_SCL_HIGH;
+        break;
+
+    case STATE_TX_ACK_SCL_HIGH:
+        interface->write_scl(HIGH_LEVEL);
+        bus->state = STATE_TX_ACK_READ;
+        break;
+
+    case STATE_TX_ACK_READ:
+        if (!interface->read_sda()) {
+            bus->state = STATE_TX_ACK_SCL_LOW;
+        } else if (++bus->ack_wait_steps > bus->ack_timeout_steps) {
+            bus->state = STATE_TX_NACK_SCL_LOW;
+        }
+        break;
+
+    case STATE_TX_ACK_SCL_LOW:
+        interface->write_scl(LOW_LEVEL);
+        i2c_async_next_byte(bus);
+        break;
+
+    case STATE_TX_NACK_SCL_LOW:
+        interface->write_scl(LOW_LEVEL);
+        i2c_async_stop(bus, I2C_ASYNC_NACK);
+        break;
+
+    /* 接收一位 */
+    case STATE_RX_RELEASE:
+        interface->write_sda(HIGH_LEVEL);
+        bus->state = STATE_RX_BIT_SCL_HIGH;
+        break;
+
+    case STATE_RX_BIT_SCL_HIGH:
+        interface->write_scl(HIGH_LEVEL);
+        bus->state = STATE_RX_BIT_READ;
+        break;
+
+    case STATE_RX_BIT_READ:
+        bus->byte = (uint8_t)((bus->byte << 1) | interface->read_sda());
+        bus->state = STATE_RX_BIT_SCL_LOW;
+        break;
+
+    case STATE_RX_BIT_SCL_LOW:
+        interface->write_scl(LOW_LEVEL);
+        if (--bus->bit_count > 0U) {
+            bus->state = STATE_RX_BIT_SCL_HIGH;
+        } else {
+            request->data[bus->index++] = bus->byte;
+            bus->state = STATE_RX_ACK_SDA;
+        }
+        break;
+
+    /* 最后一个字节发送非应答, 其他发送应答 */
+    case STATE_RX_ACK_SDA:
+        interface->write_sda((bus->index < request->len) ? LOW_LEVEL : HIGH_LEVEL);
+        bus->state = STATE_RX_ACK_SCL_HIGH;
+        break;
+
+    case STATE_RX_ACK_SCL_HIGH:
+        interface->write_scl(HIGH_LEVEL);
+        bus->state = STATE_RX_ACK_SCL_LOW;
+        break;
+
+    case STATE_RX_ACK_SCL_LOW:
+        interface->write_scl(LOW_LEVEL);
+        if (bus->index < request->len) {
+            i2c_async_receive_byte(bus);
+        } else {
+            i2c_async_stop(bus, I2C_ASYNC_DONE);
+        }
+        break;
+
+    /* 停止信号 */
+    case STATE_STOP_SDA_LOW:
+        interface->write_sda(LOW_LEVEL);
+        bus->state = STATE_STOP_SCL_HIGH;
+        break;
+
+    case STATE_STOP_SCL_HIGH:
+        interface->write_scl(HIGH_LEVEL);
+        bus->state = STATE_STOP_SDA_HIGH;
+        break;
+
+    case STATE_STOP_SDA_HIGH:
+        interface->write_sda(HIGH_LEVEL);
+        i2c_async_complete(bus);
+        break;
+
+    default:
+        bus->state = STATE_IDLE;
+        break;
+    }
+
+    return true;
+}
+
+/* 在任务中推进传输 */
+void i2c_async_run(struct i2c_async *const bus, const unsigned long step_us) {
+    while (i2c_async_step(bus)) {
+        delay_us(step_us);
+    }
+}
+
+/* 提交请求并等待完成 */
+bool i2c_async_transfer(struct i2c_async *const bus, struct i2c_async_request *const request) {
+    assert(request != NULL);
+
+    /* 事件标志位于调用任务的栈上, 完成通知在任务恢复之前结束 */
+    uint32_t done_mem[(EVENTFLAGS_BYTE + sizeof(uint32_t) - 1U) / sizeof(uint32_t)];
+    struct eventflags *const done = eventflags_init(done_mem, 0U);
+
+    request->complete = NULL;
+    request->event_flags = done;
+    request->event_mask = I2C_ASYNC_EVENT_DONE;
+
+    i2c_async_submit(bus, request);
+
+    (void)eventflags_wait(done, I2C_ASYNC_EVENT_DONE, EVENTFLAGS_WAIT_ANY);
+
+    return request->status == I2C_ASYNC_DONE;
+}
@@ -0,0 +1,238 @@
+#include <driver/i2c_bus.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/compiler.h>
+#include <zhiyec/kernel.h>
+
+/* 有新请求时通知管理任务 */
+#define I2C_BUS_EVENT_REQUEST 0x01U
+
+/* 阻塞传输完成的事件位 */
+#define I2C_BUS_EVENT_DONE 0x01U
+
+/* 可扫描的设备地址范围(不含保留地址) */
+#define I2C_BUS_SCAN_ADDR_FIRST 0x08U
+#define I2C_BUS_SCAN_ADDR_LAST 0x77U
+
+/* 初始化总线 */
+void i2c_bus_init(struct i2c_bus *const bus, i2c_software_interface *const interface, const uint32_t wait_ack_us) {
+    assert(bus != NULL);
+    assert(interface != NULL);
+
+    bus->interface = interface;
+    bus->wait_ack_us = wait_ack_us;
+
+    for (size_t i = 0; i < TASKPRIORITY_NUM; ++i) {
+        queue_list_init(bus->requests[i]);
+    }
+    bus->requests_bitmap = 0U;
+
+    bus->events = eventflags_init(bus->events_mem, 0U);
+
+    bus->served_count = 0U;
+    bus->coalesced_count = 0U;
+}
+
+/* 提交传输请求 */
+void i2c_bus_submit(struct i2c_bus *const bus, struct i2c_bus_request *const request) {
+    assert(bus != NULL);
+    assert(request != NULL);
+    assert(request->count > 0U && request->segments != NULL);
+    assert(!(request->segments[0].flags & I2C_SEGMENT_NO_START));
+
+    request->status = I2C_BUS_PENDING;
+
+    atomic({
+        queue_list_push(bus->requests[request->priority], &(request->node));
+        bus->requests_bitmap |= 1U << request->priority;
+    });
+
+    (void)eventflags_set(bus->events, I2C_BUS_EVENT_REQUEST);
+}
+
+/* 获取请求队列的第一个请求 */
+static inline struct i2c_bus_request *i2c_bus_front(struct i2c_bus *const bus, const enum task_priority priority) {
+    if (queue_list_is_empty(bus->requests[priority])) {
+        return NULL;
+    }
+
+    return container_of(queue_list_front(bus->requests[priority]), struct i2c_bus_request, node);
+}
+
+/**
+ * 取出最高优先级的请求, 以及紧随其后的同一设备的请求
+ * 返回取出的请求数, 没有请求时返回0
+ */
+static size_t i2c_bus_take(struct i2c_bus *const bus, struct i2c_bus_request **const batch) {
+    size_t batch_count = 0U;
+    size_t segment_count = 0U;
+
+    atomic_begin();
+
+    if (bus->requests_bitmap != 0U) {
+        const enum task_priority priority =
+            (enum task_priority)(31U - count_leading_zeros(bus->requests_bitmap));
+
+        for (struct i2c_bus_request *request = i2c_bus_front(bus, priority);
+             request != NULL && batch_count < I2C_BUS_COALESCE_SEGMENT_MAX;
+             request = i2c_bus_front(bus, priority)) {
+            /* 第一个请求总是取出, 之后只合并同一设备且传输段放得下的请求 */
+            if (batch_count > 0U && (request->dev_addr != batch[0]->dev_addr ||
+                                     segment_count + request->count > I2C_BUS_COALESCE_SEGMENT_MAX)) {
+                break;
+            }
+
+            queue_list_pop(bus->requests[priority]);
+            batch[batch_count++] = request;
+            segment_count += request->count;
+        }
+
+        if (queue_list_is_empty(bus->requests[priority])) {
+            bus->requests_bitmap &= ~(1U << priority);
+        }
+    }
+
+    atomic_end();
+
+    return batch_count;
+}
+
+/* 结束请求并通知提交者 */
+static void i2c_bus_complete(struct i2c_bus *const bus, struct i2c_bus_request *const request, const bool is_ok) {
+    request->status = is_ok ? I2C_BUS_DONE : I2C_BUS_FAILED;
+    ++bus->served_count;
+
+    if (request->complete != NULL) {
+        request->complete(request);
+    }
+
+    if (request->event_flags != NULL) {
+        (void)eventflags_set(request->event_flags, request->event_mask);
+    }
+}
+
+/* 传输单个请求 */
+static bool i2c_bus_do_transfer(struct i2c_bus *const bus, const struct i2c_bus_request *const request) {
+    return i2c_software_transfer(bus->interface, request->dev_addr, request->segments, request->count,
+                                 bus->wait_ack_us);
+}
+
+/* 传输下一批请求, 没有请求时返回false */
+static bool i2c_bus_serve_next(struct i2c_bus *const bus) {
+    struct i2c_bus_request *batch[I2C_BUS_COALESCE_SEGMENT_MAX];
+
+    const size_t batch_count = i2c_bus_take(bus, batch);
+    if (batch_count == 0U) {
+        return false;
+    }
+
+    if (batch_count == 1U) {
+        i2c_bus_complete(bus, batch[0], i2c_bus_do_transfer(bus, batch[0]));
+        return true;
+    }
+
+    /* 合并为一次传输, 每个请求的第一段以重复起始开始 */
+    struct i2c_segment segments[I2C_BUS_COALESCE_SEGMENT_MAX];
+    size_t segment_count = 0U;
+
+    for (size_t i = 0; i < batch_count; ++i) {
+        for (size_t j = 0; j < batch[i]->count; ++j) {
+            segments[segment_count++] = batch[i]->segments[j];
+        }
+    }
+
+    const size_t done_count =
+        i2c_software_transfer_segments(bus->interface, batch[0]->dev_addr, segments, segment_count, bus->wait_ack_us);
+
+    if (done_count == segment_count) {
+        bus->coalesced_count += batch_count - 1U;
+
+        for (size_t i = 0; i < batch_count; ++i) {
+            i2c_bus_complete(bus, batch[i], true);
+        }
+        return true;
+    }
+
+    /**
+     * 合并传输失败: 失败段之前的请求已在总线上完成, 不能重新传输(如写入EEPROM、读取后清除的寄存器);
+     * 包含失败段的请求按单独传输失败处理; 之后的请求没有传输过, 逐个传输
+     */
+    size_t segment_end = 0U;
+    size_t i = 0U;
+
+    for (; i < batch_count; ++i) {
+        segment_end += batch[i]->count;
+        if (segment_end > done_count) {
+            break;
+        }
+        i2c_bus_complete(bus, batch[i], true);
+    }
+
+    i2c_bus_complete(bus, batch[i], false);
+
+    for (++i; i < batch_count; ++i) {
+        i2c_bus_complete(bus, batch[i], i2c_bus_do_transfer(bus, batch[i]));
+    }
+
+    return true;
+}
+
+/* 总线管理任务 */
+void i2c_bus_task(void *arg) {
+    struct i2c_bus *const bus = (struct i2c_bus *)arg;
+
+    assert(bus != NULL);
+
+    for (;;) {
+        (void)eventflags_wait(bus->events, I2C_BUS_EVENT_REQUEST, EVENTFLAGS_CLEAR_ON_EXIT);
+
+        while (i2c_bus_serve_next(bus)) {
+        }
+    }
+}
+
+/* 提交请求并等待完成 */
+bool i2c_bus_transfer(struct i2c_bus *const bus, const uint8_t dev_addr,
+                      const struct i2c_segment *const segments, const size_t count) {
+    /* 请求和事件标志位于调用任务的栈上, 完成通知在任务恢复之前结束 */
+    uint32_t done_mem[(EVENTFLAGS_BYTE + sizeof(uint32_t) - 1U) / sizeof(uint32_t)];
+
+    struct i2c_bus_request request = {
+        .dev_addr = dev_addr,
+        .segments = segments,
+        .count = count,
+        .priority = task_get_priority(task_get_current()),
+        .event_flags = eventflags_init(done_mem, 0U),
+        .event_mask = I2C_BUS_EVENT_DONE,
+    };
+
+    i2c_bus_submit(bus, &request);
+
+    (void)eventflags_wait(request.event_flags, I2C_BUS_EVENT_DONE, EVENTFLAGS_WAIT_ANY);
+
+    return request.status == I2C_BUS_DONE;
+}
+
+/* 检测设备 */
+bool i2c_bus_probe(struct i2c_bus *const bus, const uint8_t dev_addr) {
+    /* 只发送地址, 不传输数据 */
+    const struct i2c_segment segment = {.data = NULL, .len = 0};
+
+    return i2c_bus_transfer(bus, dev_addr, &segment, 1U);
+}
+
+/* 扫描总线 */
+size_t i2c_bus_scan(struct i2c_bus *const bus, uint8_t *const found, const size_t max_count) {
+    size_t count = 0U;
+
+    for (uint8_t addr = I2C_BUS_SCAN_ADDR_FIRST; addr <= I2C_BUS_SCAN_ADDR_LAST; ++addr) {
+        if (i2c_bus_probe(bus, addr)) {
+            if (count < max_count) {
+                found[count] = addr;
+            }
+            ++count;
+        }
+    }
+
+    return count;
+}
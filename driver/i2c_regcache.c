@@ -0,0 +1,183 @@
+#include <driver/i2c_regcache.h>
+#include <zhiyec/assert.h>
+
+/* 位图操作 */
+#define bit_test(bits, n) (((bits)[(n) / 32U] >> ((n) % 32U)) & 1U)
+#define bit_set(bits, n) ((bits)[(n) / 32U] |= 1UL << ((n) % 32U))
+#define bit_clear(bits, n) ((bits)[(n) / 32U] &= ~(1UL << ((n) % 32U)))
+
+/* 寄存器属性 */
+#define reg_attr(cache, index) (((cache)->attrs != NULL) ? (cache)->attrs[(index)] : I2C_REG_CACHEABLE)
+
+/* 初始化寄存器缓存 */
+void i2c_regcache_init(struct i2c_regcache *const cache, i2c_software_interface *const interface,
+                       const uint8_t dev_addr, const uint32_t wait_ack_us,
+                       const uint8_t first_reg, const uint16_t reg_count,
+                       const uint8_t *const attrs, uint32_t *const mem) {
+    assert(cache != NULL);
+    assert(interface != NULL);
+    assert(mem != NULL);
+    assert((size_t)first_reg + reg_count <= 256U);
+
+    const size_t bitmap_words = (reg_count + 31U) / 32U;
+
+    cache->interface = interface;
+    cache->dev_addr = dev_addr;
+    cache->wait_ack_us = wait_ack_us;
+    cache->first_reg = first_reg;
+    cache->reg_count = reg_count;
+    cache->attrs = attrs;
+    cache->valid_bits = &mem[0];
+    cache->dirty_bits = &mem[bitmap_words];
+    cache->values = (uint8_t *)&mem[2U * bitmap_words];
+    cache->hit_count = 0U;
+    cache->transfer_count = 0U;
+
+    i2c_regcache_invalidate(cache);
+}
+
+/* 寄存器在缓存中的位置 */
+static inline size_t i2c_regcache_index(const struct i2c_regcache *const cache, const uint8_t reg) {
+    assert(reg >= cache->first_reg && reg - cache->first_reg < cache->reg_count);
+
+    return (size_t)(reg - cache->first_reg);
+}
+
+/* 设置副本的初始值 */
+void i2c_regcache_set_default(struct i2c_regcache *const cache, const uint8_t reg, const uint8_t value) {
+    assert(cache != NULL);
+
+    const size_t index = i2c_regcache_index(cache, reg);
+
+    cache->values[index] = value;
+    bit_set(cache->valid_bits, index);
+    bit_clear(cache->dirty_bits, index);
+}
+
+/* 读取寄存器 */
+bool i2c_regcache_read(struct i2c_regcache *const cache, const uint8_t reg, uint8_t *const value) {
+    assert(cache != NULL);
+    assert(value != NULL);
+
+    const size_t index = i2c_regcache_index(cache, reg);
+    const uint8_t attr = reg_attr(cache, index);
+
+    /* 副本有效且不是易变寄存器, 直接返回副本 */
+    if (!(attr & I2C_REG_VOLATILE) && bit_test(cache->valid_bits, index)) {
+        ++cache->hit_count;
+        *value = cache->values[index];
+        return true;
+    }
+
+    /* 只写寄存器不能从设备读取 */
+    if (attr & I2C_REG_WRITE_ONLY) {
+        return false;
+    }
+
+    ++cache->transfer_count;
+    if (!i2c_software_read(cache->interface, cache->dev_addr, true, reg, value, 1, cache->wait_ack_us)) {
+        return false;
+    }
+
+    if (!(attr & I2C_REG_VOLATILE)) {
+        cache->values[index] = *value;
+        bit_set(cache->valid_bits, index);
+    }
+
+    return true;
+}
+
+/* 写入寄存器 */
+bool i2c_regcache_write(struct i2c_regcache *const cache, const uint8_t reg, const uint8_t value) {
+    assert(cache != NULL);
+
+    const size_t index = i2c_regcache_index(cache, reg);
+
+    /* 易变寄存器立即写入 */
+    if (reg_attr(cache, index) & I2C_REG_VOLATILE) {
+        uint8_t data = value;
+
+        ++cache->transfer_count;
+        return i2c_software_write(cache->interface, cache->dev_addr, true, reg, &data, 1, cache->wait_ack_us);
+    }
+
+    /* 值不变时不需要写入 */
+    if (bit_test(cache->valid_bits, index) && cache->values[index] == value) {
+        return true;
+    }
+
+    cache->values[index] = value;
+    bit_set(cache->valid_bits, index);
+    bit_set(cache->dirty_bits, index);
+
+    return true;
+}
+
+/* 修改寄存器中的部分位 */
+bool i2c_regcache_update_bits(struct i2c_regcache *const cache, const uint8_t reg, const uint8_t mask,
+                              const uint8_t value) {
+    uint8_t old_value;
+
+    if (!i2c_regcache_read(cache, reg, &old_value)) {
+        return false;
+    }
+
+    return i2c_regcache_write(cache, reg, (uint8_t)((old_value & ~mask) | (value & mask)));
+}
+
+/* 干净的寄存器是否可以随相邻的脏寄存器一起写入 */
+static inline bool i2c_regcache_can_rewrite(const struct i2c_regcache *const cache, const size_t index) {
+    return bit_test(cache->valid_bits, index) && !(reg_attr(cache, index) & I2C_REG_VOLATILE);
+}
+
+/* 将脏寄存器写入设备 */
+bool i2c_regcache_flush(struct i2c_regcache *const cache) {
+    assert(cache != NULL);
+
+    bool is_ok = true;
+    size_t begin = 0U;
+
+    while (begin < cache->reg_count) {
+        if (!bit_test(cache->dirty_bits, begin)) {
+            ++begin;
+            continue;
+        }
+
+        /* 向后合并脏寄存器, 中间最多跳过 I2C_REGCACHE_MERGE_GAP 个可重新写入的干净寄存器 */
+        size_t end = begin + 1U;
+        for (size_t index = end; index < cache->reg_count; ++index) {
+            if (bit_test(cache->dirty_bits, index)) {
+                end = index + 1U;
+            } else if (index + 1U - end > I2C_REGCACHE_MERGE_GAP || !i2c_regcache_can_rewrite(cache, index)) {
+                break;
+            }
+        }
+
+        /* 副本是连续的, 直接作为写入缓冲区 */
+        ++cache->transfer_count;
+        if (i2c_software_write(cache->interface, cache->dev_addr, true, (uint8_t)(cache->first_reg + begin),
+                               &cache->values[begin], (uint16_t)(end - begin), cache->wait_ack_us)) {
+            for (size_t index = begin; index < end; ++index) {
+                bit_clear(cache->dirty_bits, index);
+            }
+        } else {
+            is_ok = false;
+        }
+
+        begin = end;
+    }
+
+    return is_ok;
+}
+
+/* 使所有副本无效 */
+void i2c_regcache_invalidate(struct i2c_regcache *const cache) {
+    assert(cache != NULL);
+
+    const size_t bitmap_words = (cache->reg_count + 31U) / 32U;
+
+    for (size_t i = 0; i < bitmap_words; ++i) {
+        cache->valid_bits[i] = 0U;
+        cache->dirty_bits[i] = 0U;
+    }
+}
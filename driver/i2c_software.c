@@ -37,9 +37,9 @@ static inline bool i2c_software_wait_ack(i2c_software_interface *i2c_software_in
 
     i2c_software_interface->write_scl(HIGH_LEVEL);
 
-    while (i2c_software_interface->read_sda()) {
-        uint32_t timeout = 0;
+    uint32_t timeout = 0;
 
+    while (i2c_software_interface->read_sda()) {
         timeout++;
         if (timeout > wait_us) {
             i2c_software_stop(i2c_software_interface);
@@ -114,6 +114,82 @@ static inline uint8_t i2c_software_read_byte(i2c_software_interface *i2c_softwar
     return byte;
 }
 
+/* 多段传输, 返回完整传输的段数 */
+size_t i2c_software_transfer_segments(i2c_software_interface *i2c_software_interface,
+                                      uint8_t dev_addr,
+                                      const struct i2c_segment *segments,
+                                      size_t count,
+                                      uint32_t wait_ack_us) {
+
+    bool need_start = true;
+
+    for (size_t i = 0; i < count; i++) {
+        const struct i2c_segment *const segment = &segments[i];
+        const bool is_read = (segment->flags & I2C_SEGMENT_READ);
+
+        // 起始信号和设备地址, 接续上一段时省略
+        if (need_start || !(segment->flags & I2C_SEGMENT_NO_START) ||
+            is_read != (bool)(segments[i - 1].flags & I2C_SEGMENT_READ)) {
+            i2c_software_start(i2c_software_interface);
+
+            i2c_software_send_byte(i2c_software_interface, (dev_addr << 1) | (is_read ? 0x01 : 0x00));
+            if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
+                i2c_software_stop(i2c_software_interface);
+                return i;
+            }
+        }
+
+        if (is_read) {
+            // 下一段接续读取时, 该段的最后一个字节仍需发送ACK
+            const bool is_continued = (i + 1 < count) &&
+                                      (segments[i + 1].flags & I2C_SEGMENT_NO_START) &&
+                                      (segments[i + 1].flags & I2C_SEGMENT_READ) &&
+                                      !(segment->flags & I2C_SEGMENT_STOP);
+
+            for (uint16_t j = 0; j < segment->len; j++) {
+                segment->data[j] = i2c_software_read_byte(i2c_software_interface);
+
+                // 最后一个字节发送NACK，其他发送ACK
+                if (j == (segment->len - 1) && !is_continued) {
+                    i2c_software_send_no_ack(i2c_software_interface);
+                } else {
+                    i2c_software_send_ack(i2c_software_interface);
+                }
+            }
+        } else {
+            for (uint16_t j = 0; j < segment->len; j++) {
+                i2c_software_send_byte(i2c_software_interface, segment->data[j]);
+                if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
+                    i2c_software_stop(i2c_software_interface);
+                    return i;
+                }
+            }
+        }
+
+        need_start = false;
+
+        if (segment->flags & I2C_SEGMENT_STOP) {
+            i2c_software_stop(i2c_software_interface);
+            need_start = true;
+        }
+    }
+
+    if (!need_start) {
+        i2c_software_stop(i2c_software_interface);
+    }
+    return count;
+}
+
+/* 多段传输 */
+bool i2c_software_transfer(i2c_software_interface *i2c_software_interface,
+                           uint8_t dev_addr,
+                           const struct i2c_segment *segments,
+                           size_t count,
+                           uint32_t wait_ack_us) {
+
+    return i2c_software_transfer_segments(i2c_software_interface, dev_addr, segments, count, wait_ack_us) == count;
+}
+
 /* 写数据 */
 bool i2c_software_write(i2c_software_interface *i2c_software_interface,
                         uint8_t dev_addr,
@@ -123,35 +199,13 @@ bool i2c_software_write(i2c_software_interface *i2c_software_interface,
                         uint16_t len,
                         uint32_t wait_ack_us) {
 
-    i2c_software_start(i2c_software_interface);
+    // 寄存器地址与数据在同一次寻址中连续发送
+    const struct i2c_segment segments[] = {
+        {.data = &reg_addr, .len = has_reg ? 1 : 0},
+        {.data = data, .len = len, .flags = I2C_SEGMENT_NO_START},
+    };
 
-    // 发送设备地址(写模式)
-    i2c_software_send_byte(i2c_software_interface, (dev_addr << 1));
-    if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
-        i2c_software_stop(i2c_software_interface);
-        return false;
-    }
-
-    // 发送寄存器地址
-    if (has_reg) {
-        i2c_software_send_byte(i2c_software_interface, reg_addr);
-        if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
-            i2c_software_stop(i2c_software_interface);
-            return false;
-        }
-    }
-
-    // 发送数据
-    for (uint16_t i = 0; i < len; i++) {
-        i2c_software_send_byte(i2c_software_interface, data[i]);
-        if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
-            i2c_software_stop(i2c_software_interface);
-            return false;
-        }
-    }
-
-    i2c_software_stop(i2c_software_interface);
-    return true;
+    return i2c_software_transfer(i2c_software_interface, dev_addr, segments, 2, wait_ack_us);
 }
 
 /* 读数据 */
@@ -163,46 +217,47 @@ bool i2c_software_read(i2c_software_interface *i2c_software_interface,
                        uint16_t len,
                        uint32_t wait_ack_us) {
 
-    i2c_software_start(i2c_software_interface);
+    // 以写模式发送寄存器地址, 重新开始后以读模式读取数据
+    const struct i2c_segment segments[] = {
+        {.data = &reg_addr, .len = has_reg ? 1 : 0},
+        {.data = data, .len = len, .flags = I2C_SEGMENT_READ},
+    };
 
-    // 发送设备地址(写模式)
-    i2c_software_send_byte(i2c_software_interface, (dev_addr << 1));
-    if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
-        i2c_software_stop(i2c_software_interface);
-        return false;
-    }
+    return i2c_software_transfer(i2c_software_interface, dev_addr, segments, 2, wait_ack_us);
+}
 
-    // 发送寄存器地址
-    if (has_reg) {
-        i2c_software_send_byte(i2c_software_interface, reg_addr);
-        if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
-            i2c_software_stop(i2c_software_interface);
-            return false;
-        }
-    }
+/* 写16位地址寄存器 */
+bool i2c_software_write_reg16(i2c_software_interface *i2c_software_interface,
+                              uint8_t dev_addr,
+                              uint16_t reg_addr,
+                              uint8_t *data,
+                              uint16_t len,
+                              uint32_t wait_ack_us) {
 
-    // 重新开始
-    i2c_software_start(i2c_software_interface);
+    uint8_t reg[2] = {(uint8_t)(reg_addr >> 8), (uint8_t)reg_addr};
 
-    // 发送设备地址(读模式)
-    i2c_software_send_byte(i2c_software_interface, (dev_addr << 1) | 0x01);
-    if (!i2c_software_wait_ack(i2c_software_interface, wait_ack_us)) {
-        i2c_software_stop(i2c_software_interface);
-        return false;
-    }
+    const struct i2c_segment segments[] = {
+        {.data = reg, .len = 2},
+        {.data = data, .len = len, .flags = I2C_SEGMENT_NO_START},
+    };
+
+    return i2c_software_transfer(i2c_software_interface, dev_addr, segments, 2, wait_ack_us);
+}
 
-    // 读取数据
-    for (uint16_t i = 0; i < len; i++) {
-        data[i] = i2c_software_read_byte(i2c_software_interface);
+/* 读16位地址寄存器 */
+bool i2c_software_read_reg16(i2c_software_interface *i2c_software_interface,
+                             uint8_t dev_addr,
+                             uint16_t reg_addr,
+                             uint8_t *data,
+                             uint16_t len,
+                             uint32_t wait_ack_us) {
 
-        // 最后一个字节发送NACK，其他发送ACK
-        if (i == (len - 1)) {
-            i2c_software_send_no_ack(i2c_software_interface);
-        } else {
-            i2c_software_send_ack(i2c_software_interface);
-        }
-    }
+    uint8_t reg[2] = {(uint8_t)(reg_addr >> 8), (uint8_t)reg_addr};
 
-    i2c_software_stop(i2c_software_interface);
-    return true;
+    const struct i2c_segment segments[] = {
+        {.data = reg, .len = 2},
+        {.data = data, .len = len, .flags = I2C_SEGMENT_READ},
+    };
+
+    return i2c_software_transfer(i2c_software_interface, dev_addr, segments, 2, wait_ack_us);
 }
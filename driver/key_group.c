@@ -0,0 +1,160 @@
+#include <driver/key_group.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/compiler.h>
+
+/* 初始化按键组 */
+void key_group_init(struct key_group *const group, const size_t key_count, uint32_t (*read_keys)(void),
+                    void (*status_changed_event)(size_t key, enum key_status status)) {
+    assert(group != NULL);
+    assert(key_count > 0U && key_count <= KEY_GROUP_MAX_KEYS);
+    assert(status_changed_event != NULL);
+
+    group->read_keys = read_keys;
+    group->status_changed_event = status_changed_event;
+    group->key_mask = (key_count == KEY_GROUP_MAX_KEYS) ? 0xFFFFFFFFU : ((1UL << key_count) - 1U);
+
+    group->debounced = 0U;
+    for (size_t i = 0; i < 4U; ++i) {
+        group->counter[i] = 0U;
+    }
+    group->timing = 0U;
+    group->ticks = 0U;
+
+    for (size_t i = 0; i < KEY_GROUP_MAX_KEYS; ++i) {
+        group->key_status[i] = KEYSTATUS_IDLE;
+        group->key_since[i] = 0U;
+    }
+}
+
+/**
+ * 对所有按键同时消抖, 返回消抖后状态翻转的按键
+ * 与消抖后状态不同的按键计数加一, 相同的按键计数清零, 计数溢出时翻转
+ */
+static inline uint32_t key_group_debounce(struct key_group *const group, const uint32_t pressed) {
+    const uint32_t delta = pressed ^ group->debounced;
+    uint32_t carry = delta;
+
+    for (size_t i = 0; i < 4U; ++i) {
+        const uint32_t plane = group->counter[i];
+
+        group->counter[i] = (plane ^ carry) & delta;
+        carry &= plane;
+    }
+
+    group->debounced ^= carry;
+
+    return carry;
+}
+
+/* 切换按键状态 */
+static inline void key_group_set_status(struct key_group *const group, const size_t key,
+                                        const enum key_status status) {
+    group->key_status[key] = (uint8_t)status;
+    group->key_since[key] = group->ticks;
+}
+
+/* 更新单个按键的状态, 触发的事件与 key_obj 相同 */
+static void key_group_update_key(struct key_group *const group, const size_t key, const bool is_key_pressed) {
+    const uint32_t key_bit = 1UL << key;
+    const unsigned int elapsed = group->ticks - group->key_since[key];
+
+    switch ((enum key_status)group->key_status[key]) {
+    case KEYSTATUS_IDLE:
+        if (is_key_pressed) {
+            key_group_set_status(group, key, KEYSTATUS_PRESSED);
+            group->timing |= key_bit;
+        }
+        break;
+
+    case KEYSTATUS_PRESSED:
+        /* 第一次松开按键, 等待双击 */
+        if (!is_key_pressed) {
+            key_group_set_status(group, key, KEYSTATUS_DOUBLE_PRESSED);
+            break;
+        }
+
+        /* 按下时长超过长按阈值 */
+        if (elapsed >= KEY_LONG_PRESSED_TICKS) {
+            key_group_set_status(group, key, KEYSTATUS_LONG_PRESSED);
+            group->timing &= ~key_bit;
+            group->status_changed_event(key, KEYSTATUS_LONG_PRESSED);
+        }
+        break;
+
+    /* 长按状态(等待按键松开) */
+    case KEYSTATUS_LONG_PRESSED:
+        if (!is_key_pressed) {
+            key_group_set_status(group, key, KEYSTATUS_IDLE);
+            group->status_changed_event(key, KEYSTATUS_IDLE);
+        }
+        break;
+
+    case KEYSTATUS_DOUBLE_PRESSED:
+        /* 双击窗口期内再次按下, 之后等待按键松开 */
+        if (is_key_pressed) {
+            key_group_set_status(group, key, KEYSTATUS_LONG_PRESSED);
+            group->timing &= ~key_bit;
+            group->status_changed_event(key, KEYSTATUS_DOUBLE_PRESSED);
+            break;
+        }
+
+        /* 双击窗口期超时, 触发普通短按事件; 按键已松开, 随后回到空闲 */
+        if (elapsed >= KEY_DOUBLE_PRESSED_TICKS) {
+            key_group_set_status(group, key, KEYSTATUS_IDLE);
+            group->timing &= ~key_bit;
+            group->status_changed_event(key, KEYSTATUS_PRESSED);
+            group->status_changed_event(key, KEYSTATUS_IDLE);
+        }
+        break;
+
+    default:
+        key_group_set_status(group, key, KEYSTATUS_IDLE);
+        group->timing &= ~key_bit;
+        break;
+    }
+}
+
+/* 输入按键采样 */
+void key_group_update(struct key_group *const group, const uint32_t pressed) {
+    assert(group != NULL);
+
+    ++group->ticks;
+
+    const uint32_t changed = key_group_debounce(group, pressed & group->key_mask);
+
+    /* 只处理状态翻转或正在计时的按键 */
+    uint32_t pending = changed | group->timing;
+
+    while (pending != 0U) {
+        const size_t key = 31U - count_leading_zeros(pending);
+
+        pending &= ~(1UL << key);
+
+        key_group_update_key(group, key, (group->debounced >> key) & 1U);
+    }
+}
+
+/* 按键组轮询 */
+void key_group_loop(struct key_group *const group) {
+    assert(group != NULL);
+    assert(group->read_keys != NULL);
+
+    key_group_update(group, group->read_keys());
+}
+
+/* 按键组是否空闲 */
+bool key_group_is_idle(const struct key_group *const group) {
+    assert(group != NULL);
+
+    /* 没有按键按下, 没有按键在消抖(计数器全为0), 也没有按键在计时 */
+    return (group->debounced | group->timing | group->counter[0] | group->counter[1] | group->counter[2] |
+            group->counter[3]) == 0U;
+}
+
+/* 获取按键的状态 */
+enum key_status key_group_get_status(const struct key_group *const group, const size_t key) {
+    assert(group != NULL);
+    assert(key < KEY_GROUP_MAX_KEYS);
+
+    return (enum key_status)group->key_status[key];
+}
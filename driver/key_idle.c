@@ -0,0 +1,44 @@
+#include <driver/key_idle.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/task.h>
+#include <zhiyec/tick.h>
+
+/* 引脚电平变化事件 */
+#define KEY_IDLE_EVENT_WAKEUP 0x01U
+
+/* 初始化空闲等待 */
+void key_idle_init(struct key_idle *const idle) {
+    assert(idle != NULL);
+
+    idle->events = eventflags_init(idle->events_mem, 0U);
+    idle->skipped_scans = 0U;
+    idle->idle_count = 0U;
+}
+
+/* 等待下一次轮询 */
+void key_idle_wait(struct key_idle *const idle, const bool is_idle) {
+    assert(idle != NULL);
+
+    if (!is_idle) {
+        task_sleep(1U);
+        return;
+    }
+
+    /* 事件标志在退出时清除, 轮询期间置位的事件使本次等待立即返回 */
+    const tick_t begin = tick_get_current();
+    (void)eventflags_wait(idle->events, KEY_IDLE_EVENT_WAKEUP, EVENTFLAGS_CLEAR_ON_EXIT);
+    const tick_t elapsed = tick_get_current() - begin;
+
+    ++idle->idle_count;
+    /* 原本在每个Tick都会轮询一次 */
+    if (elapsed > 1U) {
+        idle->skipped_scans += elapsed - 1U;
+    }
+}
+
+/* 唤醒按键任务 */
+void key_idle_wakeup_from_isr(struct key_idle *const idle) {
+    assert(idle != NULL);
+
+    (void)eventflags_set_from_isr(idle->events, KEY_IDLE_EVENT_WAKEUP);
+}
@@ -0,0 +1,142 @@
+#include <driver/key_matrix.h>
+#include <utility/delay.h>
+#include <zhiyec/assert.h>
+
+/* 按位取低n位的掩码 */
+#define key_matrix_mask(n) ((1UL << (n)) - 1U)
+
+/* 初始化矩阵键盘 */
+void key_matrix_init(struct key_matrix *const matrix, volatile uint32_t *const row_set_reg,
+                     volatile uint32_t *const row_reset_reg, const uint8_t row_shift, const uint8_t row_count,
+                     const volatile uint32_t *const column_input_reg, const uint8_t column_shift,
+                     const uint8_t column_count, const uint32_t settle_cycles, const bool has_diodes,
+                     struct key_group *const groups) {
+    assert(matrix != NULL);
+    assert(row_set_reg != NULL && row_reset_reg != NULL && column_input_reg != NULL);
+    assert(row_count > 0U && row_count <= KEY_MATRIX_MAX_ROWS && row_shift + row_count <= 32U);
+    assert(column_count > 0U && column_count <= KEY_MATRIX_MAX_COLUMNS && column_shift + column_count <= 32U);
+    assert(groups != NULL);
+
+    matrix->row_set_reg = row_set_reg;
+    matrix->row_reset_reg = row_reset_reg;
+    matrix->column_input_reg = column_input_reg;
+    matrix->row_shift = row_shift;
+    matrix->column_shift = column_shift;
+    matrix->row_count = row_count;
+    matrix->column_count = column_count;
+    matrix->settle_cycles = settle_cycles;
+    matrix->has_diodes = has_diodes;
+    matrix->groups = groups;
+
+    for (size_t i = 0; i < KEY_MATRIX_MAX_ROWS; ++i) {
+        matrix->rows[i] = 0U;
+    }
+
+    matrix->last_scan_cycles = 0U;
+    matrix->max_scan_cycles = 0U;
+    matrix->ghost_count = 0U;
+
+    /* 所有行输出高电平(不选中) */
+    *matrix->row_set_reg = key_matrix_mask(row_count) << row_shift;
+}
+
+/**
+ * 检测鬼键, 返回相关的行
+ * 无二极管时, 两行有两个以上相同的列被按下会构成矩形, 矩形的第四个角可能是虚假的按键
+ */
+static inline uint32_t key_matrix_find_ghost_rows(const uint8_t *const rows, const size_t row_count) {
+    uint32_t ghost_rows = 0U;
+
+    for (size_t i = 0; i + 1U < row_count; ++i) {
+        /* 少于两个按键的行不会构成矩形 */
+        if ((rows[i] & (rows[i] - 1U)) == 0U) {
+            continue;
+        }
+
+        for (size_t j = i + 1U; j < row_count; ++j) {
+            const uint32_t common = rows[i] & rows[j];
+
+            if ((common & (common - 1U)) != 0U) {
+                ghost_rows |= (1UL << i) | (1UL << j);
+            }
+        }
+    }
+
+    return ghost_rows;
+}
+
+/* 扫描矩阵键盘 */
+bool key_matrix_scan(struct key_matrix *const matrix, uint32_t *const pressed) {
+    assert(matrix != NULL);
+    assert(pressed != NULL);
+
+    const uint32_t start_value = SYSTICK_VALUE_REG;
+
+    const size_t row_count = matrix->row_count;
+    const size_t column_count = matrix->column_count;
+    const uint32_t row_pins = key_matrix_mask(row_count) << matrix->row_shift;
+    const uint32_t column_mask = key_matrix_mask(column_count);
+    uint8_t rows[KEY_MATRIX_MAX_ROWS];
+
+    /* 逐行输出低电平, 按下的按键将所在列拉低 */
+    *matrix->row_set_reg = row_pins;
+    for (size_t row = 0; row < row_count; ++row) {
+        const uint32_t row_pin = 1UL << (matrix->row_shift + row);
+
+        *matrix->row_reset_reg = row_pin;
+        delay_cycles(matrix->settle_cycles);
+        rows[row] = (uint8_t)((~*matrix->column_input_reg >> matrix->column_shift) & column_mask);
+        *matrix->row_set_reg = row_pin;
+    }
+
+    /* 相关行只接受松开的按键, 新按下的按键等到鬼键消失后再接受 */
+    const uint32_t ghost_rows = matrix->has_diodes ? 0U : key_matrix_find_ghost_rows(rows, row_count);
+    if (ghost_rows != 0U) {
+        ++matrix->ghost_count;
+    }
+
+    for (size_t i = 0; i < KEY_MATRIX_GROUP_NUM(row_count * column_count); ++i) {
+        pressed[i] = 0U;
+    }
+
+    for (size_t row = 0; row < row_count; ++row) {
+        if ((ghost_rows >> row) & 1U) {
+            rows[row] &= matrix->rows[row];
+        }
+        matrix->rows[row] = rows[row];
+
+        /* 一行可能跨越两个按键组 */
+        const size_t bit = row * column_count;
+        const size_t shift = bit % KEY_GROUP_MAX_KEYS;
+
+        pressed[bit / KEY_GROUP_MAX_KEYS] |= (uint32_t)rows[row] << shift;
+        if (shift + column_count > KEY_GROUP_MAX_KEYS) {
+            pressed[bit / KEY_GROUP_MAX_KEYS + 1U] |= (uint32_t)rows[row] >> (KEY_GROUP_MAX_KEYS - shift);
+        }
+    }
+
+    matrix->last_scan_cycles = delay_elapsed_cycles(start_value);
+    if (matrix->last_scan_cycles > matrix->max_scan_cycles) {
+        matrix->max_scan_cycles = matrix->last_scan_cycles;
+    }
+
+    return ghost_rows != 0U;
+}
+
+/* 矩阵键盘轮询 */
+void key_matrix_loop(struct key_matrix *const matrix) {
+    uint32_t pressed[KEY_MATRIX_GROUP_NUM(KEY_MATRIX_MAX_KEYS)];
+
+    (void)key_matrix_scan(matrix, pressed);
+
+    for (size_t i = 0; i < KEY_MATRIX_GROUP_NUM(matrix->row_count * matrix->column_count); ++i) {
+        key_group_update(&matrix->groups[i], pressed[i]);
+    }
+}
+
+/* 所有行输出低电平 */
+void key_matrix_select_all(struct key_matrix *const matrix) {
+    assert(matrix != NULL);
+
+    *matrix->row_reset_reg = key_matrix_mask(matrix->row_count) << matrix->row_shift;
+}
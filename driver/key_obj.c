@@ -1,13 +1,6 @@
 #include <driver/key_obj.h>
 #include <zhiyec/assert.h>
 
-/* 防抖时长 */
-#define DEBOUNCE_TICKS 15U
-/* 长按判定时长 */
-#define LONG_PRESSED_TICKS 600U
-/* 双击判定间隔时长 */
-#define DOUBLE_PRESSED_TICKS 300U
-
 void key_init(struct key_obj *key_obj,
               bool (*is_pressed)(void), void (*status_changed_event)(enum key_status)) {
     assert(key_obj != NULL);
@@ -44,7 +37,7 @@ static inline void key_update_status(struct key_obj *const key_obj) {
 
     case KEYSTATUS_PRESS_DELAY:
         key_obj->key_ticks++;
-        if (key_obj->key_ticks < DEBOUNCE_TICKS) {
+        if (key_obj->key_ticks < KEY_DEBOUNCE_TICKS) {
             break;
         }
         key_obj->key_ticks = 0U;
@@ -74,7 +67,7 @@ static inline void key_update_status(struct key_obj *const key_obj) {
 
     case KEYSTATUS_RELEASE_DELAY:
         key_obj->key_ticks++;
-        if (key_obj->key_ticks < DEBOUNCE_TICKS) {
+        if (key_obj->key_ticks < KEY_DEBOUNCE_TICKS) {
             break;
         }
         key_obj->key_ticks = 0U;
@@ -111,7 +104,7 @@ static inline void key_update_status(struct key_obj *const key_obj) {
 
         key_obj->key_ticks++;
         /* 按下时长超过长按阈值 */
-        if (key_obj->key_ticks >= LONG_PRESSED_TICKS) {
+        if (key_obj->key_ticks >= KEY_LONG_PRESSED_TICKS) {
             next_status = KEYSTATUS_LONG_PRESSED;
             trigger_event = true;
             event_status = KEYSTATUS_LONG_PRESSED;
@@ -136,7 +129,7 @@ static inline void key_update_status(struct key_obj *const key_obj) {
 
         key_obj->key_ticks++;
         /* 双击窗口期超时 */
-        if (key_obj->key_ticks >= DOUBLE_PRESSED_TICKS) {
+        if (key_obj->key_ticks >= KEY_DOUBLE_PRESSED_TICKS) {
             next_status = KEYSTATUS_LONG_PRESSED;
             /* 触发普通短按事件 */
             trigger_event = true;
@@ -169,3 +162,17 @@ void key_loop(struct key_obj *key_obj, size_t count) {
         count--;
     }
 }
+
+bool key_is_idle(const struct key_obj *key_obj, size_t count) {
+    assert(key_obj != NULL);
+
+    while (count > 0U) {
+        if (key_obj->key_status != KEYSTATUS_IDLE) {
+            return false;
+        }
+        key_obj++;
+        count--;
+    }
+
+    return true;
+}
@@ -34,10 +34,34 @@
 /* 是否开启硬件加速任务切换 */
 #define ENABLE_HARDWARE_ACCELERATED_TASK_SWITCHING 1
 
+/* 是否启用队列集合 */
+#define USE_QUEUE_SET 0
+
+/* 是否启用内核信息查询(任务状态与栈用量、CPU占用、内核对象注册) */
+#define USE_KERNEL_INTROSPECTION 0
+
 /* 是否使用动态内存分配 */
 #define USE_DYNAMIC_MEMORY_ALLOCATION 0
 
 /*****/ /* 配置内存池大小(当启用动态内存分配时有效) */
 /*****/ #define CONFIG_MEMORYPOOL_SIZE 4096
 
+/*****/ /* 配置内存池所在内存的属性(当启用动态内存分配时有效), 见 memory.h */
+/*****/ #define CONFIG_MEMORYPOOL_REGION_FLAGS (MEMORY_REGION_DMA)
+
+/*****/ /* 配置内存区域的最大数量, 包括内存池(当启用动态内存分配时有效) */
+/*****/ #define CONFIG_MEMORY_REGION_MAX_NUM 4
+
+/*****/ /* 配置单次分配的最大内存大小, 决定堆控制块的大小(当启用动态内存分配时有效) */
+/*****/ #define CONFIG_MEMORY_BLOCK_SIZE_MAX (CONFIG_MEMORYPOOL_SIZE)
+
+/*****/ /* 配置缓存行大小(当启用动态内存分配时有效) */
+/*****/ #define CONFIG_CACHE_LINE_SIZE 32
+
+/*****/ /* 是否记录内存分配跟踪(当启用动态内存分配时有效) */
+/*****/ #define USE_MEMORY_TRACE 0
+
+/*****/ /* 配置内存分配跟踪的记录数量, 必须是2的幂(当启用内存分配跟踪时有效) */
+/*****/ #define CONFIG_MEMORY_TRACE_DEPTH 64
+
 #endif /* _ZHIYEC_CONFIG_H */
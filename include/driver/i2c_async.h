@@ -0,0 +1,124 @@
+/**
+ * @file i2c_async.h
+ * @author Zhiyelah
+ * @brief 非阻塞软件模拟I2C通信
+ * @note 使用 i2c_software_interface 操作引脚, 由状态机逐步推进传输, 每一步只改变或读取一次引脚电平;
+ *       在定时器中断中调用 i2c_async_step, 或在高优先级任务中调用 i2c_async_run;
+ *       定时器的频率为SCL频率的三倍(每一位分三步), 定时器中断的优先级需可被内核屏蔽;
+ *       传输期间调用任务可以继续执行, 完成后通过回调函数或事件标志通知; 依赖事件标志模块
+ */
+
+#ifndef _I2C_ASYNC_H
+#define _I2C_ASYNC_H
+
+#include <driver/i2c_software.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <zhiyec/list.h>
+
+struct eventflags;
+
+enum i2c_async_status {
+    /* 等待传输 */
+    I2C_ASYNC_PENDING = 0U,
+    /* 正在传输 */
+    I2C_ASYNC_BUSY,
+    /* 传输成功 */
+    I2C_ASYNC_DONE,
+    /* 从设备无应答 */
+    I2C_ASYNC_NACK,
+};
+
+/* 传输请求(由调用者分配, 完成前不可释放) */
+struct i2c_async_request {
+    /* 请求链表节点 */
+    struct slist_head node;
+    /* 7位设备地址 */
+    uint8_t dev_addr;
+    /* 是否有寄存器 */
+    bool has_reg;
+    /* 寄存器地址 */
+    uint8_t reg_addr;
+    /* 是否为读操作 */
+    bool is_read;
+    /* 数据缓冲区 */
+    uint8_t *data;
+    /* 数据长度 */
+    uint16_t len;
+    /* 传输状态 */
+    volatile enum i2c_async_status status;
+    /* 完成回调函数(可为NULL, 在调用 i2c_async_step 的上下文中执行) */
+    void (*complete)(struct i2c_async_request *request);
+    /* 完成时置位的事件标志(可为NULL) */
+    struct eventflags *event_flags;
+    /* 完成时置位的事件位 */
+    uint32_t event_mask;
+};
+
+struct i2c_async {
+    /* I2C读写接口 */
+    i2c_software_interface *interface;
+    /* 等待应答的最大步数 */
+    uint32_t ack_timeout_steps;
+    /* 等待传输的请求 */
+    struct queue_list requests;
+    /* 正在传输的请求 */
+    struct i2c_async_request *volatile current;
+
+    /* 状态机 */
+    volatile uint8_t state;
+    /* 当前传输阶段 */
+    uint8_t phase;
+    /* 当前字节剩余的位数 */
+    uint8_t bit_count;
+    /* 当前字节 */
+    uint8_t byte;
+    /* 数据位置 */
+    uint16_t index;
+    /* 已等待应答的步数 */
+    uint32_t ack_wait_steps;
+};
+
+/**
+ * @brief 初始化非阻塞I2C总线
+ * @param bus 总线对象
+ * @param interface I2C读写接口(接口函数中不需要延时)
+ * @param ack_timeout_steps 等待应答的最大步数
+ */
+void i2c_async_init(struct i2c_async *const bus, i2c_software_interface *const interface,
+                    const uint32_t ack_timeout_steps);
+
+/**
+ * @brief 提交传输请求
+ * @param bus 总线对象
+ * @param request 传输请求, 需先设置地址、数据和完成通知
+ * @note 立即返回, 请求按提交顺序传输; 不可在中断中调用
+ */
+void i2c_async_submit(struct i2c_async *const bus, struct i2c_async_request *const request);
+
+/**
+ * @brief 推进一步传输
+ * @param bus 总线对象
+ * @return 总线是否仍在传输
+ * @note 在定时器中断或高优先级任务中周期调用, 同一总线只能在一个上下文中调用
+ */
+bool i2c_async_step(struct i2c_async *const bus);
+
+/**
+ * @brief 在任务中推进传输, 直到所有请求完成
+ * @param bus 总线对象
+ * @param step_us 每一步之间的延时(单位: 微秒)
+ * @note 用于不使用定时器的场景, 调用任务在传输期间忙等
+ */
+void i2c_async_run(struct i2c_async *const bus, const unsigned long step_us);
+
+/**
+ * @brief 提交传输请求并阻塞等待完成
+ * @param bus 总线对象
+ * @param request 传输请求, 其中的完成通知会被覆盖
+ * @return 是否传输成功
+ * @note 依赖事件标志模块; 等待期间调用任务不占用CPU, 需由定时器推进传输
+ */
+bool i2c_async_transfer(struct i2c_async *const bus, struct i2c_async_request *const request);
+
+#endif /* _I2C_ASYNC_H */
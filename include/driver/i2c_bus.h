@@ -0,0 +1,127 @@
+/**
+ * @file i2c_bus.h
+ * @author Zhiyelah
+ * @brief I2C总线管理
+ * @note 每条总线由一个管理任务独占访问, 其他任务提交请求后由管理任务按优先级依次传输, 不需要自行加锁;
+ *       同一优先级中连续的同一设备的请求合并为一次传输(以重复起始连接),
+ *       合并传输失败时, 已完成的请求不会重新传输, 失败的请求结束为 I2C_BUS_FAILED, 未执行的请求逐个传输;
+ *       依赖事件标志模块
+ */
+
+#ifndef _I2C_BUS_H
+#define _I2C_BUS_H
+
+#include <driver/i2c_software.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zhiyec/event_flags.h>
+#include <zhiyec/list.h>
+#include <zhiyec/task.h>
+
+/* 单次合并传输的最大传输段数量 */
+#define I2C_BUS_COALESCE_SEGMENT_MAX 8
+
+enum i2c_bus_status {
+    /* 等待传输 */
+    I2C_BUS_PENDING = 0U,
+    /* 传输成功 */
+    I2C_BUS_DONE,
+    /* 传输失败 */
+    I2C_BUS_FAILED,
+};
+
+/* 传输请求(由调用者分配, 完成前不可释放) */
+struct i2c_bus_request {
+    /* 请求链表节点 */
+    struct slist_head node;
+    /* 7位设备地址 */
+    uint8_t dev_addr;
+    /* 传输段数组, 第一段不能为 I2C_SEGMENT_NO_START */
+    const struct i2c_segment *segments;
+    /* 传输段数量 */
+    size_t count;
+    /* 请求优先级, 高优先级的请求先传输 */
+    enum task_priority priority;
+    /* 传输状态 */
+    volatile enum i2c_bus_status status;
+    /* 完成回调函数(可为NULL, 在管理任务中执行) */
+    void (*complete)(struct i2c_bus_request *request);
+    /* 完成时置位的事件标志(可为NULL) */
+    struct eventflags *event_flags;
+    /* 完成时置位的事件位 */
+    uint32_t event_mask;
+};
+
+struct i2c_bus {
+    /* I2C读写接口 */
+    i2c_software_interface *interface;
+    /* 等待应答时间 */
+    uint32_t wait_ack_us;
+    /* 各优先级的请求队列 */
+    struct queue_list requests[TASKPRIORITY_NUM];
+    /* 非空请求队列的位图 */
+    uint32_t requests_bitmap;
+    /* 通知管理任务 */
+    struct eventflags *events;
+    uint32_t events_mem[(EVENTFLAGS_BYTE + sizeof(uint32_t) - 1U) / sizeof(uint32_t)];
+
+    /* 已完成的请求数 */
+    volatile size_t served_count;
+    /* 被合并到其他请求中传输的请求数 */
+    volatile size_t coalesced_count;
+};
+
+/**
+ * @brief 初始化总线
+ * @param bus 总线对象
+ * @param interface I2C读写接口
+ * @param wait_ack_us 等待应答时间
+ */
+void i2c_bus_init(struct i2c_bus *const bus, i2c_software_interface *const interface, const uint32_t wait_ack_us);
+
+/**
+ * @brief 总线管理任务函数
+ * @param arg 总线对象
+ * @note 每条总线创建一个任务, 优先级不低于提交请求的任务, 以免高优先级的请求被中等优先级的任务阻塞
+ */
+void i2c_bus_task(void *arg);
+
+/**
+ * @brief 提交传输请求
+ * @param bus 总线对象
+ * @param request 传输请求, 需先设置地址、传输段、优先级和完成通知
+ * @note 立即返回; 不可在中断中调用
+ */
+void i2c_bus_submit(struct i2c_bus *const bus, struct i2c_bus_request *const request);
+
+/**
+ * @brief 提交传输请求并阻塞等待完成
+ * @param bus 总线对象
+ * @param dev_addr 7位设备地址
+ * @param segments 传输段数组
+ * @param count 传输段数量
+ * @return 是否传输成功
+ * @note 请求的优先级为当前任务的优先级
+ */
+bool i2c_bus_transfer(struct i2c_bus *const bus, const uint8_t dev_addr,
+                      const struct i2c_segment *const segments, const size_t count);
+
+/**
+ * @brief 检测设备是否应答
+ * @param bus 总线对象
+ * @param dev_addr 7位设备地址
+ * @return 设备是否应答
+ */
+bool i2c_bus_probe(struct i2c_bus *const bus, const uint8_t dev_addr);
+
+/**
+ * @brief 扫描总线上的设备(地址0x08~0x77)
+ * @param bus 总线对象
+ * @param found 应答的设备地址
+ * @param max_count 数组大小
+ * @return 应答的设备数量(可能大于max_count)
+ */
+size_t i2c_bus_scan(struct i2c_bus *const bus, uint8_t *const found, const size_t max_count);
+
+#endif /* _I2C_BUS_H */
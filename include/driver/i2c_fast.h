@@ -0,0 +1,288 @@
+/**
+ * @file i2c_fast.h
+ * @author Zhiyelah
+ * @brief 编译期特化的软件模拟I2C通信
+ * @note 与 i2c_software 的区别: 引脚操作为直接写GPIO寄存器, 由 I2C_FAST_DEFINE 为每条总线生成专用函数,
+ *       总线参数均为编译期常量, 不经过函数指针; 边沿之间按CPU周期延时, 可选择总线速率, 支持时钟延展;
+ *       延时基于SysTick计数, 需在调度器启动(SysTick启动)后使用
+ */
+
+#ifndef _I2C_FAST_H
+#define _I2C_FAST_H
+
+#include <config.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <utility/delay.h>
+#include <zhiyec/compiler.h>
+
+/**
+ * [引脚初始化]
+ * 将SCL和SDA引脚设置为开漏输出, 并初始设置为高电平(高阻态), 输入寄存器需能读取两个引脚的电平
+ */
+
+/* 总线速率 */
+#define I2C_FAST_SPEED_STANDARD 100000U  // 标准模式 100kHz
+#define I2C_FAST_SPEED_FAST 400000U      // 快速模式 400kHz
+#define I2C_FAST_SPEED_FAST_PLUS 1000000U // 快速模式+ 1MHz
+
+/* 每个半周期中引脚操作本身消耗的周期数(估计值), 从延时中扣除 */
+#define I2C_FAST_EDGE_OVERHEAD_CYCLES 12U
+
+/* 等待从设备释放SCL(时钟延展)的最大轮询次数 */
+#define I2C_FAST_STRETCH_MAX_POLLS 100000U
+
+/**
+ * @brief 计算半个SCL周期的延时周期数
+ * @param bus_hz 总线速率
+ */
+#define I2C_FAST_HALF_PERIOD_CYCLES(bus_hz)                                          \
+    ((CONFIG_CPU_CLOCK_HZ / (2U * (bus_hz)) > I2C_FAST_EDGE_OVERHEAD_CYCLES)        \
+         ? (CONFIG_CPU_CLOCK_HZ / (2U * (bus_hz)) - I2C_FAST_EDGE_OVERHEAD_CYCLES) \
+         : 0U)
+
+struct i2c_fast_bus {
+    /* 置位寄存器, 写1的位输出高电平(释放) */
+    volatile uint32_t *set_reg;
+    /* 复位寄存器, 写1的位输出低电平 */
+    volatile uint32_t *reset_reg;
+    /* 写入复位寄存器时引脚掩码的左移位数(使用BSRR的高16位复位时为16) */
+    uint32_t reset_shift;
+    /* 输入寄存器 */
+    const volatile uint32_t *input_reg;
+    /* SCL引脚掩码 */
+    uint32_t scl_mask;
+    /* SDA引脚掩码 */
+    uint32_t sda_mask;
+    /* 半个SCL周期的延时周期数 */
+    uint32_t half_period_cycles;
+};
+
+/**
+ * @brief 定义一条I2C总线并生成专用函数
+ * @param name 总线名称
+ * @param set_reg 置位寄存器地址
+ * @param reset_reg 复位寄存器地址
+ * @param reset_shift 写入复位寄存器时引脚掩码的左移位数
+ * @param input_reg 输入寄存器地址
+ * @param scl_mask SCL引脚掩码
+ * @param sda_mask SDA引脚掩码
+ * @param bus_hz 总线速率, 如 I2C_FAST_SPEED_FAST
+ * @note 例如 STM32F1 的 PB6/PB7:
+ *           I2C_FAST_DEFINE(imu_i2c, &GPIOB->BSRR, &GPIOB->BRR, 0, &GPIOB->IDR, 1U << 6, 1U << 7, I2C_FAST_SPEED_FAST);
+ *       没有BRR的型号使用BSRR的高16位复位:
+ *           I2C_FAST_DEFINE(imu_i2c, &GPIOB->BSRR, &GPIOB->BSRR, 16, &GPIOB->IDR, 1U << 6, 1U << 7, I2C_FAST_SPEED_FAST);
+ *       生成以下函数, 参数与 i2c_software_write/i2c_software_read 相同(没有接口和应答等待时间):
+ *           bool name_write(uint8_t dev_addr, bool has_reg, uint8_t reg_addr, const uint8_t *data, uint16_t len);
+ *           bool name_read(uint8_t dev_addr, bool has_reg, uint8_t reg_addr, uint8_t *data, uint16_t len);
+ *           void name_recover(void);
+ */
+#define I2C_FAST_DEFINE(name, set_reg_addr, reset_reg_addr, shift, input_reg_addr, scl, sda, bus_hz)            \
+    static const struct i2c_fast_bus name##_bus = {                                                             \
+        .set_reg = (volatile uint32_t *)(set_reg_addr),                                                         \
+        .reset_reg = (volatile uint32_t *)(reset_reg_addr),                                                     \
+        .reset_shift = (shift),                                                                                 \
+        .input_reg = (const volatile uint32_t *)(input_reg_addr),                                               \
+        .scl_mask = (scl),                                                                                      \
+        .sda_mask = (sda),                                                                                      \
+        .half_period_cycles = I2C_FAST_HALF_PERIOD_CYCLES(bus_hz),                                              \
+    };                                                                                                          \
+                                                                                                                \
+    static inline bool name##_write(const uint8_t dev_addr, const bool has_reg, const uint8_t reg_addr,         \
+                                    const uint8_t *const data, const uint16_t len) {                           \
+        return i2c_fast_write(&name##_bus, dev_addr, has_reg, reg_addr, data, len);                             \
+    }                                                                                                           \
+                                                                                                                \
+    static inline bool name##_read(const uint8_t dev_addr, const bool has_reg, const uint8_t reg_addr,          \
+                                   uint8_t *const data, const uint16_t len) {                                  \
+        return i2c_fast_read(&name##_bus, dev_addr, has_reg, reg_addr, data, len);                              \
+    }                                                                                                           \
+                                                                                                                \
+    static inline void name##_recover(void) {                                                                   \
+        i2c_fast_recover(&name##_bus);                                                                          \
+    }
+
+/* 以下为 I2C_FAST_DEFINE 生成的函数所使用的内部实现, 总线对象为编译期常量时全部展开为寄存器操作 */
+
+/* 释放引脚(输出高电平) */
+static always_inline void i2c_fast_release(const struct i2c_fast_bus *const bus, const uint32_t mask) {
+    *bus->set_reg = mask;
+}
+
+/* 拉低引脚 */
+static always_inline void i2c_fast_pull_low(const struct i2c_fast_bus *const bus, const uint32_t mask) {
+    *bus->reset_reg = mask << bus->reset_shift;
+}
+
+/* 半个SCL周期的延时 */
+static always_inline void i2c_fast_delay(const struct i2c_fast_bus *const bus) {
+    delay_cycles(bus->half_period_cycles);
+}
+
+/* 释放SCL, 并等待从设备结束时钟延展, 超时返回false */
+static always_inline bool i2c_fast_scl_high(const struct i2c_fast_bus *const bus) {
+    i2c_fast_release(bus, bus->scl_mask);
+
+    for (uint32_t polls = 0U; (*bus->input_reg & bus->scl_mask) == 0U; ++polls) {
+        if (polls >= I2C_FAST_STRETCH_MAX_POLLS) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* 读取SDA */
+static always_inline uint8_t i2c_fast_read_sda(const struct i2c_fast_bus *const bus) {
+    return ((*bus->input_reg & bus->sda_mask) != 0U) ? 1U : 0U;
+}
+
+/* 起始信号(进入时SCL为低电平或总线空闲), 也用于重复起始 */
+static always_inline bool i2c_fast_start(const struct i2c_fast_bus *const bus) {
+    i2c_fast_release(bus, bus->sda_mask);
+    i2c_fast_delay(bus);
+    if (!i2c_fast_scl_high(bus)) {
+        return false;
+    }
+    i2c_fast_delay(bus);
+    i2c_fast_pull_low(bus, bus->sda_mask);
+    i2c_fast_delay(bus);
+    i2c_fast_pull_low(bus, bus->scl_mask);
+
+    return true;
+}
+
+/* 停止信号(进入时SCL为低电平) */
+static always_inline void i2c_fast_stop(const struct i2c_fast_bus *const bus) {
+    i2c_fast_pull_low(bus, bus->sda_mask);
+    i2c_fast_delay(bus);
+    (void)i2c_fast_scl_high(bus);
+    i2c_fast_delay(bus);
+    i2c_fast_release(bus, bus->sda_mask);
+    i2c_fast_delay(bus);
+}
+
+/* 发送一个字节, 返回是否收到应答 */
+static always_inline bool i2c_fast_send_byte(const struct i2c_fast_bus *const bus, uint8_t byte) {
+    for (uint8_t i = 0; i < 8; ++i, byte <<= 1) {
+        if (byte & 0x80) {
+            i2c_fast_release(bus, bus->sda_mask);
+        } else {
+            i2c_fast_pull_low(bus, bus->sda_mask);
+        }
+
+        i2c_fast_delay(bus);
+        if (!i2c_fast_scl_high(bus)) {
+            return false;
+        }
+        i2c_fast_delay(bus);
+        i2c_fast_pull_low(bus, bus->scl_mask);
+    }
+
+    /* 释放SDA, 在第9个时钟读取应答 */
+    i2c_fast_release(bus, bus->sda_mask);
+    i2c_fast_delay(bus);
+    if (!i2c_fast_scl_high(bus)) {
+        return false;
+    }
+    i2c_fast_delay(bus);
+    const bool is_ack = (i2c_fast_read_sda(bus) == 0U);
+    i2c_fast_pull_low(bus, bus->scl_mask);
+
+    return is_ack;
+}
+
+/* 接收一个字节, 并发送应答(ack为true)或非应答 */
+static always_inline uint8_t i2c_fast_read_byte(const struct i2c_fast_bus *const bus, const bool ack) {
+    uint8_t byte = 0U;
+
+    i2c_fast_release(bus, bus->sda_mask);
+
+    for (uint8_t i = 0; i < 8; ++i) {
+        i2c_fast_delay(bus);
+        (void)i2c_fast_scl_high(bus);
+        i2c_fast_delay(bus);
+        byte = (uint8_t)((byte << 1) | i2c_fast_read_sda(bus));
+        i2c_fast_pull_low(bus, bus->scl_mask);
+    }
+
+    if (ack) {
+        i2c_fast_pull_low(bus, bus->sda_mask);
+    }
+    i2c_fast_delay(bus);
+    (void)i2c_fast_scl_high(bus);
+    i2c_fast_delay(bus);
+    i2c_fast_pull_low(bus, bus->scl_mask);
+
+    return byte;
+}
+
+/* 发送设备地址和寄存器地址 */
+static always_inline bool i2c_fast_address(const struct i2c_fast_bus *const bus, const uint8_t dev_addr,
+                                           const bool has_reg, const uint8_t reg_addr) {
+    if (!i2c_fast_start(bus)) {
+        return false;
+    }
+
+    if (!i2c_fast_send_byte(bus, (uint8_t)(dev_addr << 1))) {
+        return false;
+    }
+
+    if (has_reg && !i2c_fast_send_byte(bus, reg_addr)) {
+        return false;
+    }
+
+    return true;
+}
+
+/* 写数据 */
+static always_inline bool i2c_fast_write(const struct i2c_fast_bus *const bus, const uint8_t dev_addr,
+                                         const bool has_reg, const uint8_t reg_addr,
+                                         const uint8_t *const data, const uint16_t len) {
+    bool is_ok = i2c_fast_address(bus, dev_addr, has_reg, reg_addr);
+
+    for (uint16_t i = 0; is_ok && i < len; ++i) {
+        is_ok = i2c_fast_send_byte(bus, data[i]);
+    }
+
+    i2c_fast_stop(bus);
+    return is_ok;
+}
+
+/* 读数据 */
+static always_inline bool i2c_fast_read(const struct i2c_fast_bus *const bus, const uint8_t dev_addr,
+                                        const bool has_reg, const uint8_t reg_addr,
+                                        uint8_t *const data, const uint16_t len) {
+    /* 没有寄存器时直接以读模式寻址 */
+    bool is_ok = !has_reg || i2c_fast_address(bus, dev_addr, true, reg_addr);
+
+    /* 重新开始, 以读模式寻址 */
+    is_ok = is_ok && i2c_fast_start(bus) && i2c_fast_send_byte(bus, (uint8_t)((dev_addr << 1) | 0x01));
+
+    for (uint16_t i = 0; is_ok && i < len; ++i) {
+        /* 最后一个字节发送非应答, 其他发送应答 */
+        data[i] = i2c_fast_read_byte(bus, i + 1U < len);
+    }
+
+    i2c_fast_stop(bus);
+    return is_ok;
+}
+
+/* 总线恢复: 同时释放两个引脚, 再发送9个时钟使卡住的从设备释放SDA, 最后发送停止信号 */
+static always_inline void i2c_fast_recover(const struct i2c_fast_bus *const bus) {
+    i2c_fast_release(bus, bus->scl_mask | bus->sda_mask);
+    i2c_fast_delay(bus);
+
+    for (uint8_t i = 0; i < 9 && i2c_fast_read_sda(bus) == 0U; ++i) {
+        i2c_fast_pull_low(bus, bus->scl_mask);
+        i2c_fast_delay(bus);
+        (void)i2c_fast_scl_high(bus);
+        i2c_fast_delay(bus);
+    }
+
+    i2c_fast_pull_low(bus, bus->scl_mask);
+    i2c_fast_delay(bus);
+    i2c_fast_stop(bus);
+}
+
+#endif /* _I2C_FAST_H */
@@ -0,0 +1,131 @@
+/**
+ * @file i2c_regcache.h
+ * @author Zhiyelah
+ * @brief I2C设备寄存器缓存
+ * @note 为一段连续地址的8位寄存器保存影子副本: 可缓存寄存器的读取直接返回副本, 写入只修改副本并标记为脏,
+ *       由 i2c_regcache_flush 将相邻的脏寄存器合并为一次连续写入(要求设备支持寄存器地址自动递增);
+ *       同一个缓存不能在多个任务中同时使用
+ */
+
+#ifndef _I2C_REGCACHE_H
+#define _I2C_REGCACHE_H
+
+#include <driver/i2c_software.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum i2c_reg_attr {
+    /* 可缓存: 第一次读取后从副本读取, 写入在刷新时发送 */
+    I2C_REG_CACHEABLE = 0x00U,
+    /* 易变(如状态寄存器): 总是从设备读取, 写入立即发送 */
+    I2C_REG_VOLATILE = 0x01U,
+    /* 只写: 读取只返回副本, 不访问设备 */
+    I2C_REG_WRITE_ONLY = 0x02U,
+};
+
+/* 刷新时两段脏寄存器之间最多可跳过的干净寄存器数量(跳过的寄存器重新写入副本中的值) */
+#define I2C_REGCACHE_MERGE_GAP 2U
+
+/**
+ * @brief 计算缓存所需的内存大小(单位: 32位字)
+ * @param reg_count 寄存器数量
+ */
+#define I2C_REGCACHE_MEM_WORDS(reg_count) (2U * (((reg_count) + 31U) / 32U) + ((reg_count) + 3U) / 4U)
+
+struct i2c_regcache {
+    /* I2C读写接口 */
+    i2c_software_interface *interface;
+    /* 7位设备地址 */
+    uint8_t dev_addr;
+    /* 等待应答时间 */
+    uint32_t wait_ack_us;
+    /* 第一个寄存器的地址 */
+    uint8_t first_reg;
+    /* 寄存器数量 */
+    uint16_t reg_count;
+    /* 寄存器属性(可为NULL, 为NULL时全部可缓存) */
+    const uint8_t *attrs;
+    /* 副本是否有效的位图 */
+    uint32_t *valid_bits;
+    /* 副本是否被修改的位图 */
+    uint32_t *dirty_bits;
+    /* 寄存器副本 */
+    uint8_t *values;
+
+    /* 从副本读取的次数 */
+    size_t hit_count;
+    /* 访问设备的传输次数 */
+    size_t transfer_count;
+};
+
+/**
+ * @brief 初始化寄存器缓存
+ * @param cache 缓存对象
+ * @param interface I2C读写接口
+ * @param dev_addr 7位设备地址
+ * @param wait_ack_us 等待应答时间
+ * @param first_reg 第一个寄存器的地址
+ * @param reg_count 寄存器数量(第一个寄存器的地址加寄存器数量不超过256)
+ * @param attrs 每个寄存器的属性, 见 enum i2c_reg_attr(可为NULL)
+ * @param mem 缓存内存, 大小为 I2C_REGCACHE_MEM_WORDS(reg_count)
+ * @note 初始时所有副本无效, 只写寄存器需先通过 i2c_regcache_write 或 i2c_regcache_set_default 设置副本
+ */
+void i2c_regcache_init(struct i2c_regcache *const cache, i2c_software_interface *const interface,
+                       const uint8_t dev_addr, const uint32_t wait_ack_us,
+                       const uint8_t first_reg, const uint16_t reg_count,
+                       const uint8_t *const attrs, uint32_t *const mem);
+
+/**
+ * @brief 设置副本的初始值(如设备复位后的默认值), 不访问设备
+ * @param cache 缓存对象
+ * @param reg 寄存器地址
+ * @param value 寄存器的值
+ */
+void i2c_regcache_set_default(struct i2c_regcache *const cache, const uint8_t reg, const uint8_t value);
+
+/**
+ * @brief 读取寄存器
+ * @param cache 缓存对象
+ * @param reg 寄存器地址
+ * @param value 寄存器的值
+ * @return 是否读取成功, 只写寄存器的副本无效时返回false
+ */
+bool i2c_regcache_read(struct i2c_regcache *const cache, const uint8_t reg, uint8_t *const value);
+
+/**
+ * @brief 写入寄存器
+ * @param cache 缓存对象
+ * @param reg 寄存器地址
+ * @param value 寄存器的值
+ * @return 是否写入成功
+ * @note 易变寄存器立即写入设备, 其他寄存器只修改副本, 值不变时不标记为脏
+ */
+bool i2c_regcache_write(struct i2c_regcache *const cache, const uint8_t reg, const uint8_t value);
+
+/**
+ * @brief 修改寄存器中的部分位
+ * @param cache 缓存对象
+ * @param reg 寄存器地址
+ * @param mask 需修改的位
+ * @param value 新的值(只使用mask中的位)
+ * @return 是否修改成功
+ * @note 副本有效时不访问设备
+ */
+bool i2c_regcache_update_bits(struct i2c_regcache *const cache, const uint8_t reg, const uint8_t mask,
+                              const uint8_t value);
+
+/**
+ * @brief 将脏寄存器写入设备
+ * @param cache 缓存对象
+ * @return 是否全部写入成功, 失败的寄存器保持为脏
+ */
+bool i2c_regcache_flush(struct i2c_regcache *const cache);
+
+/**
+ * @brief 使所有副本无效(如设备复位后), 未刷新的修改被丢弃
+ * @param cache 缓存对象
+ */
+void i2c_regcache_invalidate(struct i2c_regcache *const cache);
+
+#endif /* _I2C_REGCACHE_H */
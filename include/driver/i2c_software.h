@@ -8,6 +8,7 @@
 #define _I2C_SOFTWARE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -27,6 +28,58 @@ typedef struct {
     void (*write_scl)(uint8_t bit);
 } i2c_software_interface;
 
+enum i2c_segment_flag {
+    /* 读数据(否则为写数据) */
+    I2C_SEGMENT_READ = 0x01U,
+    /* 不发送起始信号和地址, 直接接续上一段的数据(方向需与上一段相同), 用于分散的缓冲区 */
+    I2C_SEGMENT_NO_START = 0x02U,
+    /* 该段结束后发送停止信号, 下一段以起始信号开始(否则以重复起始开始) */
+    I2C_SEGMENT_STOP = 0x04U,
+};
+
+/* 传输段 */
+struct i2c_segment {
+    /* 数据缓冲区 */
+    uint8_t *data;
+    /* 数据长度 */
+    uint16_t len;
+    /* 传输段标志, 见 enum i2c_segment_flag */
+    uint8_t flags;
+};
+
+/**
+ * @brief 执行由多个传输段组成的I2C传输
+ * @param i2c_software_interface I2C读写接口
+ * @param dev_addr: 7位设备地址(函数内已左移一位)
+ * @param segments 传输段数组
+ * @param count 传输段数量
+ * @param wait_ack_us 等待应答时间
+ * @return true: 传输成功; false: 传输失败
+ * @note 段之间默认使用重复起始, 整个传输结束时发送停止信号; 例如读取寄存器:
+ *           {.data = &reg, .len = 1}, {.data = buf, .len = n, .flags = I2C_SEGMENT_READ}
+ */
+bool i2c_software_transfer(i2c_software_interface *i2c_software_interface,
+                           uint8_t dev_addr,
+                           const struct i2c_segment *segments,
+                           size_t count,
+                           uint32_t wait_ack_us);
+
+/**
+ * @brief 执行多段传输, 返回完整传输的段数
+ * @param i2c_software_interface I2C读写接口
+ * @param dev_addr: 7位设备地址(函数内已左移一位)
+ * @param segments 传输段数组
+ * @param count 传输段数量
+ * @param wait_ack_us 等待应答时间
+ * @return 完整传输的段数, 等于count时传输成功; 小于count时第返回值个段失败, 之后的段没有传输
+ * @note 用于需要知道失败位置的场景(如合并传输失败后只重新传输未执行的部分)
+ */
+size_t i2c_software_transfer_segments(i2c_software_interface *i2c_software_interface,
+                                      uint8_t dev_addr,
+                                      const struct i2c_segment *segments,
+                                      size_t count,
+                                      uint32_t wait_ack_us);
+
 /**
  * @brief 向I2C设备写入数据
  * @param i2c_software_interface I2C读写接口
@@ -65,4 +118,38 @@ bool i2c_software_read(i2c_software_interface *i2c_software_interface,
                        uint16_t len,
                        uint32_t wait_ack_us);
 
+/**
+ * @brief 向I2C设备的16位地址寄存器写入数据
+ * @param i2c_software_interface I2C读写接口
+ * @param dev_addr: 7位设备地址(函数内已左移一位)
+ * @param reg_addr: 16位寄存器地址(高字节先发送)
+ * @param data: 要写入的数据缓冲区
+ * @param len: 数据长度
+ * @param wait_ack_us 等待应答时间
+ * @return true: 写入成功; false: 写入失败
+ */
+bool i2c_software_write_reg16(i2c_software_interface *i2c_software_interface,
+                              uint8_t dev_addr,
+                              uint16_t reg_addr,
+                              uint8_t *data,
+                              uint16_t len,
+                              uint32_t wait_ack_us);
+
+/**
+ * @brief 从I2C设备的16位地址寄存器读取数据
+ * @param i2c_software_interface I2C读写接口
+ * @param dev_addr: 7位设备地址(函数内已左移一位)
+ * @param reg_addr: 16位寄存器地址(高字节先发送)
+ * @param data: 用于存储读取数据的缓冲区(数组)
+ * @param len: 要读取的数据长度
+ * @param wait_ack_us 等待应答时间
+ * @return true: 读取成功; false: 读取失败
+ */
+bool i2c_software_read_reg16(i2c_software_interface *i2c_software_interface,
+                             uint8_t dev_addr,
+                             uint16_t reg_addr,
+                             uint8_t *data,
+                             uint16_t len,
+                             uint32_t wait_ack_us);
+
 #endif /* _I2C_SOFTWARE_H */
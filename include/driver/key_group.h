@@ -0,0 +1,84 @@
+/**
+ * @file key_group.h
+ * @author Zhiyelah
+ * @brief 批量按键检测
+ * @note 一次读取最多32个按键(每位一个按键), 用垂直计数器对所有按键同时消抖,
+ *       只对消抖后状态改变或正在计时(长按、双击窗口)的按键执行状态机;
+ *       触发的事件与 key_obj 相同, 见 enum key_status
+ */
+
+#ifndef _KEY_GROUP_H
+#define _KEY_GROUP_H
+
+#include <driver/key_obj.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 单组最大按键数量 */
+#define KEY_GROUP_MAX_KEYS 32U
+
+struct key_group {
+    /* 读取所有按键, 第n位为1表示第n个按键按下(可为NULL, 为NULL时只能通过 key_group_update 输入) */
+    uint32_t (*read_keys)(void);
+    /* 按键状态改变事件回调 */
+    void (*status_changed_event)(size_t key, enum key_status status);
+    /* 有效按键的掩码 */
+    uint32_t key_mask;
+
+    /* 消抖后的按键状态 */
+    uint32_t debounced;
+    /* 垂直计数器(每个位平面保存所有按键计数值的一位), 按键状态与消抖后的状态连续不同16次时翻转 */
+    uint32_t counter[4];
+    /* 正在计时的按键 */
+    uint32_t timing;
+
+    /* Tick计数 */
+    unsigned int ticks;
+    /* 各按键的状态 */
+    uint8_t key_status[KEY_GROUP_MAX_KEYS];
+    /* 各按键进入当前状态的时间 */
+    unsigned int key_since[KEY_GROUP_MAX_KEYS];
+};
+
+/**
+ * @brief 初始化按键组
+ * @param group 按键组
+ * @param key_count 按键数量(不超过 KEY_GROUP_MAX_KEYS)
+ * @param read_keys 读取所有按键的函数(可为NULL)
+ * @param status_changed_event 按键状态改变事件回调, 参数为按键序号和事件
+ */
+void key_group_init(struct key_group *const group, const size_t key_count, uint32_t (*read_keys)(void),
+                    void (*status_changed_event)(size_t key, enum key_status status));
+
+/**
+ * @brief 按键组轮询
+ * @param group 按键组
+ * @note 读取按键并更新状态, 每个Tick调用一次
+ */
+void key_group_loop(struct key_group *const group);
+
+/**
+ * @brief 输入一次按键采样并更新状态
+ * @param group 按键组
+ * @param pressed 按键采样, 第n位为1表示第n个按键按下
+ * @note 用于由其他方式(如矩阵扫描)获得按键状态的场景, 每个Tick调用一次
+ */
+void key_group_update(struct key_group *const group, const uint32_t pressed);
+
+/**
+ * @brief 查询按键组是否空闲
+ * @param group 按键组
+ * @return 是否没有按键按下、消抖或计时
+ * @note 空闲时可停止轮询, 见 key_idle.h
+ */
+bool key_group_is_idle(const struct key_group *const group);
+
+/**
+ * @brief 获取按键的状态
+ * @param group 按键组
+ * @param key 按键序号
+ */
+enum key_status key_group_get_status(const struct key_group *const group, const size_t key);
+
+#endif /* _KEY_GROUP_H */
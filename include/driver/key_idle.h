@@ -0,0 +1,64 @@
+/**
+ * @file key_idle.h
+ * @author Zhiyelah
+ * @brief 按键空闲等待
+ * @note 所有按键空闲时停止周期轮询, 按键任务阻塞到引脚电平变化中断唤醒;
+ *       有按键正在消抖或处于按键手势中(长按、双击窗口)时每个Tick轮询一次
+ *       使用示例:
+ *         for (;;) {
+ *             key_loop(keys, KEY_NUM);
+ *             key_idle_wait(&key_idle, key_is_idle(keys, KEY_NUM));
+ *         }
+ *       引脚电平变化中断中调用 key_idle_wakeup_from_isr(&key_idle)
+ */
+
+#ifndef _KEY_IDLE_H
+#define _KEY_IDLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zhiyec/event_flags.h>
+
+struct key_idle {
+    /* 唤醒按键任务的事件标志 */
+    struct eventflags *events;
+    uint32_t events_mem[(EVENTFLAGS_BYTE + sizeof(uint32_t) - 1U) / sizeof(uint32_t)];
+
+    /* 空闲等待期间跳过的轮询次数(Tick数) */
+    size_t skipped_scans;
+    /* 进入空闲等待的次数 */
+    size_t idle_count;
+};
+
+/**
+ * @brief 初始化空闲等待
+ * @param idle 空闲等待对象
+ */
+void key_idle_init(struct key_idle *const idle);
+
+/**
+ * @brief 等待下一次轮询
+ * @param idle 空闲等待对象
+ * @param is_idle 按键是否全部空闲, 见 key_is_idle 和 key_group_is_idle
+ * @note 不空闲时睡眠一个Tick; 空闲时阻塞到 key_idle_wakeup_from_isr 被调用,
+ *       在轮询期间发生的中断会使下一次空闲等待立即返回, 不会丢失按键
+ */
+void key_idle_wait(struct key_idle *const idle, const bool is_idle);
+
+/**
+ * @brief 唤醒按键任务
+ * @param idle 空闲等待对象
+ * @note 在引脚电平变化中断中调用, 也可在任务中调用
+ */
+void key_idle_wakeup_from_isr(struct key_idle *const idle);
+
+/**
+ * @brief 获取空闲等待期间跳过的轮询次数
+ * @param idle 空闲等待对象
+ */
+static inline size_t key_idle_get_skipped_scans(const struct key_idle *const idle) {
+    return idle->skipped_scans;
+}
+
+#endif /* _KEY_IDLE_H */
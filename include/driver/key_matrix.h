@@ -0,0 +1,105 @@
+/**
+ * @file key_matrix.h
+ * @author Zhiyelah
+ * @brief 矩阵键盘扫描
+ * @note 行引脚和列引脚各自位于同一个端口的连续位上, 逐行输出低电平并一次读取整个列端口,
+ *       扫描结果(第 row * column_count + column 位为1表示按键按下)输入 key_group 消抖和检测按键手势;
+ *       行引脚配置为开漏输出(或带二极管的推挽输出), 列引脚配置为上拉输入
+ */
+
+#ifndef _KEY_MATRIX_H
+#define _KEY_MATRIX_H
+
+#include <driver/key_group.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 最大行数和列数 */
+#define KEY_MATRIX_MAX_ROWS 8U
+#define KEY_MATRIX_MAX_COLUMNS 8U
+
+/* 最大按键数量 */
+#define KEY_MATRIX_MAX_KEYS (KEY_MATRIX_MAX_ROWS * KEY_MATRIX_MAX_COLUMNS)
+
+/* 保存所有按键所需的按键组数量 */
+#define KEY_MATRIX_GROUP_NUM(key_count) (((key_count) + KEY_GROUP_MAX_KEYS - 1U) / KEY_GROUP_MAX_KEYS)
+
+struct key_matrix {
+    /* 行端口置位寄存器(写1置位, 如BSRR) */
+    volatile uint32_t *row_set_reg;
+    /* 行端口复位寄存器(写1复位, 如BRR) */
+    volatile uint32_t *row_reset_reg;
+    /* 列端口输入寄存器(如IDR) */
+    const volatile uint32_t *column_input_reg;
+    /* 第一个行引脚和列引脚的位置 */
+    uint8_t row_shift;
+    uint8_t column_shift;
+    /* 行数和列数 */
+    uint8_t row_count;
+    uint8_t column_count;
+    /* 输出行电平后等待列电平稳定的时钟周期数 */
+    uint32_t settle_cycles;
+    /* 每个按键是否串联了二极管(有二极管时不会出现鬼键) */
+    bool has_diodes;
+
+    /* 按键组, 第n组保存第 n * 32 到 n * 32 + 31 个按键 */
+    struct key_group *groups;
+
+    /* 每行上一次接受的扫描结果 */
+    uint8_t rows[KEY_MATRIX_MAX_ROWS];
+
+    /* 上一次扫描和最长一次扫描的时钟周期数 */
+    uint32_t last_scan_cycles;
+    uint32_t max_scan_cycles;
+    /* 检测到鬼键的扫描次数 */
+    size_t ghost_count;
+};
+
+/**
+ * @brief 初始化矩阵键盘
+ * @param matrix 矩阵键盘
+ * @param row_set_reg 行端口置位寄存器
+ * @param row_reset_reg 行端口复位寄存器
+ * @param row_shift 第一个行引脚的位置
+ * @param row_count 行数(不超过 KEY_MATRIX_MAX_ROWS)
+ * @param column_input_reg 列端口输入寄存器
+ * @param column_shift 第一个列引脚的位置
+ * @param column_count 列数(不超过 KEY_MATRIX_MAX_COLUMNS)
+ * @param settle_cycles 输出行电平后等待列电平稳定的时钟周期数
+ * @param has_diodes 每个按键是否串联了二极管
+ * @param groups 按键组数组, 大小为 KEY_MATRIX_GROUP_NUM(row_count * column_count),
+ *               需先用 key_group_init 初始化(read_keys 为NULL)
+ */
+void key_matrix_init(struct key_matrix *const matrix, volatile uint32_t *const row_set_reg,
+                     volatile uint32_t *const row_reset_reg, const uint8_t row_shift, const uint8_t row_count,
+                     const volatile uint32_t *const column_input_reg, const uint8_t column_shift,
+                     const uint8_t column_count, const uint32_t settle_cycles, const bool has_diodes,
+                     struct key_group *const groups);
+
+/**
+ * @brief 扫描矩阵键盘
+ * @param matrix 矩阵键盘
+ * @param pressed 扫描结果, 大小为 KEY_MATRIX_GROUP_NUM(row_count * column_count)
+ * @return 是否检测到鬼键
+ * @note 扫描时间固定为 row_count 次(输出行电平, 等待 settle_cycles, 读取列端口),
+ *       不随按下的按键数量变化; 扫描时间记录在 last_scan_cycles 和 max_scan_cycles 中(包含被中断的时间)
+ *       检测到鬼键时, 相关行新按下的按键被忽略, 松开的按键照常更新
+ */
+bool key_matrix_scan(struct key_matrix *const matrix, uint32_t *const pressed);
+
+/**
+ * @brief 矩阵键盘轮询
+ * @param matrix 矩阵键盘
+ * @note 扫描矩阵键盘并更新所有按键组, 每个Tick调用一次
+ */
+void key_matrix_loop(struct key_matrix *const matrix);
+
+/**
+ * @brief 所有行输出低电平
+ * @param matrix 矩阵键盘
+ * @note 用于按键空闲时等待列引脚电平变化中断, 见 key_idle.h; 下一次扫描时自动恢复
+ */
+void key_matrix_select_all(struct key_matrix *const matrix);
+
+#endif /* _KEY_MATRIX_H */
@@ -10,6 +10,13 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+/* 防抖时长 */
+#define KEY_DEBOUNCE_TICKS 15U
+/* 长按判定时长 */
+#define KEY_LONG_PRESSED_TICKS 600U
+/* 双击判定间隔时长 */
+#define KEY_DOUBLE_PRESSED_TICKS 300U
+
 enum key_status {
     KEYSTATUS_IDLE = 0,
     KEYSTATUS_PRESS_DELAY,
@@ -50,4 +57,13 @@ void key_init(struct key_obj *key_obj,
  */
 void key_loop(struct key_obj *key_obj, size_t count);
 
+/**
+ * @brief 查询按键对象是否全部空闲
+ * @param key_obj 按键对象(数组)
+ * @param count 如果是数组则输入数组大小，否则为1
+ * @return 是否全部空闲, 在 key_loop 之后调用时, 空闲表示最近一次采样时没有按键按下
+ * @note 全部空闲时可停止轮询, 见 key_idle.h
+ */
+bool key_is_idle(const struct key_obj *key_obj, size_t count);
+
 #endif /* _KEY_OBJ_H */
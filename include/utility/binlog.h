@@ -0,0 +1,106 @@
+/**
+ * @file binlog.h
+ * @author Zhiyelah
+ * @brief 二进制日志
+ * @note 日志调用只记录格式字符串的地址、时间戳和参数字, 不在MCU上格式化;
+ *       由主机端工具 tools/binlog_decode.py 读取ELF文件中的格式字符串还原文本.
+ *       格式字符串位于 .binlog 段, 该段不需要加载到Flash, 链接脚本中需添加:
+ *           .binlog 0 (INFO) : { KEEP(*(.binlog)) }
+ *       (GNU ld 链接脚本, 其他链接器需将该段放入不烧录的区域), 日志ID即格式字符串在该段中的地址;
+ *       每个参数被转换为一个32位字, 浮点数需使用 binlog_float 转换; 不支持 %s
+ */
+
+#ifndef _BINLOG_H
+#define _BINLOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility/fmt.h>
+#include <zhiyec/compiler.h>
+
+/* 单条日志的最大参数数量 */
+#define BINLOG_ARGS_MAX 8
+
+/**
+ * 记录格式(32位字, 小端):
+ *   [标记 | 参数数量] [格式字符串地址] [时间戳] [参数 0 .. n-1]
+ * 记录头最后写入, 发送者以此判断记录是否已写完
+ */
+#define BINLOG_MARKER 0xB10C0000U
+#define BINLOG_MARKER_MASK 0xFFFF0000U
+#define BINLOG_RECORD_WORDS(nargs) (3U + (nargs))
+
+/**
+ * @brief 初始化二进制日志
+ * @param buffer 环形缓冲区
+ * @param word_count 缓冲区大小(单位: 32位字), 必须是2的幂
+ */
+void binlog_init(uint32_t *const buffer, const size_t word_count);
+
+/**
+ * @brief 写入一条日志记录
+ * @param format 格式字符串(必须位于 .binlog 段)
+ * @param nargs 参数数量
+ * @param args 参数
+ * @return 是否写入成功, 缓冲区空间不足时丢弃
+ * @note 无锁, 可在任务和中断中调用; 通常通过 binlog 宏调用
+ */
+bool binlog_write(const char *const format, const uint32_t nargs, const uint32_t *const args);
+
+/**
+ * @brief 将已写完的日志记录发送到打印流
+ * @param stream 打印流
+ * @note 同一时刻只能有一个发送者
+ */
+void binlog_flush(const struct PrintStream *const stream);
+
+/**
+ * @brief 获取因缓冲区空间不足而丢弃的日志数量
+ */
+size_t binlog_get_dropped(void);
+
+/**
+ * @brief 将浮点数按位转换为参数字
+ * @param value 浮点数
+ */
+static inline uint32_t binlog_float(const float value) {
+    union {
+        float f;
+        uint32_t u;
+    } word = {.f = value};
+
+    return word.u;
+}
+
+/* 参数个数 */
+#define BINLOG_NARGS(...) BINLOG_NARGS_INNER(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define BINLOG_NARGS_INNER(_0, _1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+/* 将每个参数转换为32位字 */
+#define BINLOG_WORD(x) ((uint32_t)(uintptr_t)(x))
+#define BINLOG_WORDS_0()
+#define BINLOG_WORDS_1(a) BINLOG_WORD(a)
+#define BINLOG_WORDS_2(a, ...) BINLOG_WORD(a), BINLOG_WORDS_1(__VA_ARGS__)
+#define BINLOG_WORDS_3(a, ...) BINLOG_WORD(a), BINLOG_WORDS_2(__VA_ARGS__)
+#define BINLOG_WORDS_4(a, ...) BINLOG_WORD(a), BINLOG_WORDS_3(__VA_ARGS__)
+#define BINLOG_WORDS_5(a, ...) BINLOG_WORD(a), BINLOG_WORDS_4(__VA_ARGS__)
+#define BINLOG_WORDS_6(a, ...) BINLOG_WORD(a), BINLOG_WORDS_5(__VA_ARGS__)
+#define BINLOG_WORDS_7(a, ...) BINLOG_WORD(a), BINLOG_WORDS_6(__VA_ARGS__)
+#define BINLOG_WORDS_8(a, ...) BINLOG_WORD(a), BINLOG_WORDS_7(__VA_ARGS__)
+#define BINLOG_WORDS(n, ...) BINLOG_WORDS_INNER(n, ##__VA_ARGS__)
+#define BINLOG_WORDS_INNER(n, ...) BINLOG_WORDS_##n(__VA_ARGS__)
+
+/**
+ * @brief 记录一条二进制日志
+ * @param format 格式字符串字面量
+ * @param ... 参数(最多 BINLOG_ARGS_MAX 个)
+ */
+#define binlog(format, ...)                                                                          \
+    do {                                                                                             \
+        static const char binlog_format[] section(".binlog") used = format;                          \
+        const uint32_t binlog_args[] = {0U, BINLOG_WORDS(BINLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)}; \
+        (void)binlog_write(binlog_format, BINLOG_NARGS(__VA_ARGS__), &binlog_args[1]);               \
+    } while (0)
+
+#endif /* _BINLOG_H */
@@ -2,26 +2,70 @@
  * @file console.h
  * @author Zhiyelah
  * @brief 控制台支持
- * @note 可通过终端模式下的串口工具与MCU交互
+ * @note 可通过终端模式下的串口工具与MCU交互;
+ *       依赖事件标志模块, 串口接收中断中调用 console_input_char_from_isr, 命令在控制台任务中执行
  */
 
 #ifndef _CONSOLE_H
 #define _CONSOLE_H
 
+#include <zhiyec/compiler.h>
+
 struct console_cmd {
     const char *name;                       // 命令名称
     const char *description;                // 命令描述
     int (*handler)(int argc, char *argv[]); // 命令处理函数
 };
 
+/**
+ * @brief 静态注册控制台命令
+ * @param cmd_name 命令名称
+ * @param cmd_description 命令描述
+ * @param cmd_handler 命令处理函数
+ * @note 命令对象放置在 console_cmd 段中, 数量不受限制;
+ *       指定对齐以防止编译器为对象增加对齐, 使段中的对象紧密排列成数组
+ *       没有代码按符号引用命令对象, 链接器删除未使用的段时必须保留 console_cmd 段, 否则命令会被静默删除:
+ *         armlink: 添加链接选项 --keep=*(console_cmd) (Keil: Options -> Linker -> Misc controls)
+ *         GNU ld(--gc-sections): 在链接脚本中使用 KEEP(*(console_cmd)) 放置该段
+ *       used 属性只防止编译器删除对象, 段的 $$Base/$$Limit 或 __start_/__stop_ 符号也不会使链接器保留该段
+ */
+#define CONSOLE_CMD_REGISTER(cmd_name, cmd_description, cmd_handler)                \
+    static const struct console_cmd console_cmd_##cmd_handler section("console_cmd") \
+        aligned(sizeof(void *)) used = {                                            \
+            .name = (cmd_name),                                                     \
+            .description = (cmd_description),                                       \
+            .handler = (cmd_handler),                                               \
+        }
+
+/**
+ * @brief 初始化控制台
+ * @note 需在开启串口接收中断之前调用
+ */
+void console_init(void);
+
+/**
+ * @brief 控制台任务函数, 处理中断中输入的字符并执行命令
+ * @param arg 未使用
+ * @note 可作为 task_create 的任务函数, 通常使用较低的优先级
+ */
+void console_task(void *arg);
+
+/**
+ * @brief 在中断中向控制台输入一个字符
+ * @param ch 输入的字符
+ * @note 中断安全, 仅允许一个中断调用; 输入缓冲区满时丢弃字符
+ */
+void console_input_char_from_isr(char ch);
+
 /**
  * @brief 向控制台输入一个字符
  * @param ch 输入的字符
+ * @note 在调用任务中直接处理字符并执行命令
  */
 void console_input_char(char ch);
 
 /**
- * @brief 注册控制台命令
+ * @brief 运行时注册控制台命令
  * @param cmd 控制台命令对象
  */
 void console_register_cmd(const struct console_cmd *const cmd);
@@ -0,0 +1,126 @@
+/**
+ * @file control_loop.h
+ * @author Zhiyelah
+ * @brief 多速率控制回路执行器
+ * @note 由一个周期任务(或定时器中断)按固定顺序执行多个控制阶段, 每个阶段以基本周期的整数倍运行,
+ *       并可设置相位偏移以错开同频率的阶段; 记录每个阶段的执行时间和超时次数
+ *       阶段之间以 control_signal 传递数据, 读写不加锁
+ */
+
+#ifndef _CONTROL_LOOP_H
+#define _CONTROL_LOOP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zhiyec/list.h>
+#include <zhiyec/types.h>
+
+struct control_stage {
+    struct slist_head node;
+
+    /* 阶段函数 */
+    void (*fn)(void *arg);
+    void *arg;
+    /* 每 divider 个基本周期运行一次 */
+    uint16_t divider;
+    /* 在第 phase 个基本周期第一次运行(小于 divider) */
+    uint16_t phase;
+    /* 距离下一次运行的基本周期数 */
+    uint16_t countdown;
+    /* 执行时间预算(时钟周期数, 为0时不检查) */
+    uint32_t budget_cycles;
+
+    /* 上一次和最长一次的执行时间(时钟周期数) */
+    uint32_t last_cycles;
+    uint32_t max_cycles;
+    /* 运行次数 */
+    size_t run_count;
+    /* 执行时间超过预算的次数 */
+    size_t overrun_count;
+};
+
+struct control_loop {
+    /* 按执行顺序排列的阶段 */
+    struct queue_list stages;
+    /* 基本周期(Tick数), 只用于 control_loop_task */
+    tick_t period;
+    /* 已执行的基本周期数 */
+    size_t cycle_count;
+    /* 一个基本周期的执行时间超过基本周期的次数, 只用于 control_loop_task */
+    size_t overrun_count;
+};
+
+/**
+ * @brief 初始化控制回路
+ * @param loop 控制回路
+ * @param period 基本周期(Tick数), 由 control_loop_task 执行时使用
+ */
+void control_loop_init(struct control_loop *const loop, const tick_t period);
+
+/**
+ * @brief 添加阶段, 阶段按添加的顺序执行
+ * @param loop 控制回路
+ * @param stage 阶段
+ * @param fn 阶段函数
+ * @param arg 阶段函数的参数
+ * @param divider 速率比, 每 divider 个基本周期运行一次
+ * @param phase 相位偏移, 小于 divider
+ * @param budget_cycles 执行时间预算(时钟周期数, 为0时不检查)
+ * @note 需在开始执行之前添加
+ */
+void control_loop_add(struct control_loop *const loop, struct control_stage *const stage,
+                      void (*const fn)(void *arg), void *const arg, const uint16_t divider,
+                      const uint16_t phase, const uint32_t budget_cycles);
+
+/**
+ * @brief 执行一个基本周期
+ * @param loop 控制回路
+ * @note 可在定时器中断中调用; 阶段的执行时间按SysTick计算, 需小于一个Tick, 且包含被中断的时间
+ */
+void control_loop_step(struct control_loop *const loop);
+
+/**
+ * @brief 控制回路任务
+ * @param arg 控制回路
+ * @note 每个基本周期执行一次 control_loop_step, 任务优先级应高于其他使用同一数据的任务
+ */
+void control_loop_task(void *arg);
+
+struct control_signal {
+    /* 写入序号, 读取者根据最低位选择稳定的副本 */
+    volatile uint32_t sequence;
+    /* 两个数据副本 */
+    void *copies;
+    /* 数据大小 */
+    size_t size;
+};
+
+/**
+ * @brief 初始化信号
+ * @param signal 信号
+ * @param mem 数据内存, 大小为 2 * size
+ * @param size 数据大小
+ * @param init_value 初始值(可为NULL, 为NULL时初始值为0)
+ */
+void control_signal_init(struct control_signal *const signal, void *const mem, const size_t size,
+                         const void *const init_value);
+
+/**
+ * @brief 写入信号
+ * @param signal 信号
+ * @param value 数据
+ * @note 同一个信号只能有一个写入者
+ */
+void control_signal_write(struct control_signal *const signal, const void *const value);
+
+/**
+ * @brief 读取信号
+ * @param signal 信号
+ * @param value 数据
+ * @note 不会读到写了一半的数据; 读取者打断写入者时读取上一次写入的值, 不需要等待,
+ *       因此可在中断中读取; 写入者打断读取者时重新读取
+ */
+void control_signal_read(const struct control_signal *const signal, void *const value);
+
+#endif /* _CONTROL_LOOP_H */
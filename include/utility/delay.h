@@ -7,9 +7,37 @@
 #ifndef _DELAY_H
 #define _DELAY_H
 
+#include <asm/systick.h>
+#include <stdint.h>
+
 /**
  * @brief 微秒延时
  */
 void delay_us(const unsigned long us);
 
+/**
+ * @brief 获取从某个SysTick计数值开始经过的时钟周期数
+ * @param start_value 开始时的计数值(SYSTICK_VALUE_REG)
+ * @note 经过的时间需小于一个SysTick周期
+ */
+static inline uint32_t delay_elapsed_cycles(const uint32_t start_value) {
+    const uint32_t curr_value = SYSTICK_VALUE_REG;
+
+    /* SysTick向下计数, 到0后重装载 */
+    return (curr_value <= start_value) ? (start_value - curr_value)
+                                       : (start_value + SYSTICK_LOAD_REG + 1U - curr_value);
+}
+
+/**
+ * @brief 时钟周期延时
+ * @param cycles 时钟周期数, 需小于SysTick的重装载值
+ * @note 按SysTick计数, 精度为读取一次计数值的时间(约数个周期), 需在SysTick启动后调用
+ */
+static inline void delay_cycles(const uint32_t cycles) {
+    const uint32_t start_value = SYSTICK_VALUE_REG;
+
+    while (delay_elapsed_cycles(start_value) < cycles) {
+    }
+}
+
 #endif /* _DELAY_H */
@@ -2,15 +2,35 @@
  * @file fmt.h
  * @author Zhiyelah
  * @brief 格式化输入输出
+ * @note 默认在调用任务中直接输出; 启用异步模式后, 每次调用的输出整体提交到环形缓冲区, 由输出任务或DMA发送
  */
 
 #ifndef _ZHIYEC_FMT_H
 #define _ZHIYEC_FMT_H
 
+#include <stdarg.h>
+#include <stddef.h>
+
 enum task_priority;
 
 struct PrintStream {
+    /* 输出一个字符 */
     void (*write)(char);
+    /* 输出一段字符(可为NULL, 为NULL时逐个字符调用write) */
+    void (*write_block)(const char *, size_t);
+};
+
+/* 异步模式下缓冲区满时的处理策略, 超过缓冲区容量的输出总是被丢弃 */
+enum fmt_overflow_policy {
+    /* 丢弃放不下的整条输出 */
+    FMT_OVERFLOW_DROP = 0U,
+    /* 阻塞调用任务直到缓冲区有足够空间(由 fmt_async_consume 释放数据时唤醒, 期间持有打印锁) */
+    FMT_OVERFLOW_BLOCK,
+    /**
+     * 按整条输出丢弃最旧的未发送输出; 正在发送(已由 fmt_async_get_pending 取走)或已发送一部分的输出不会被覆盖,
+     * 此时丢弃当前输出
+     */
+    FMT_OVERFLOW_OVERWRITE,
 };
 
 /**
@@ -20,6 +40,16 @@ struct PrintStream {
  */
 void fmt_init(struct PrintStream *print_stream, const enum task_priority print_lock_ceiling_priority);
 
+/**
+ * @brief 启用异步模式
+ * @param buffer 环形缓冲区
+ * @param size 缓冲区大小
+ * @param policy 缓冲区满时的处理策略
+ * @note 需在 fmt_init 之后、开始打印之前调用;
+ *       需创建任务运行 fmt_drain_task, 或由DMA通过 fmt_async_get_pending 和 fmt_async_consume 发送数据
+ */
+void fmt_enable_async(char *const buffer, const size_t size, const enum fmt_overflow_policy policy);
+
 /**
  * @brief 打印
  */
@@ -32,7 +62,57 @@ void fmt_println(const char *str);
 
 /**
  * @brief 格式化打印
+ * @note 使用内置的格式化实现, 不分配内存; 支持的格式:
+ *       标志 '-' '0' '+' ' ' '#', 宽度与精度(可为'*'), 长度修饰 'hh' 'h' 'l' 'll' 'j' 'z',
+ *       转换 d i u x X c s p f %; %f 为定点实现, 整数部分需小于2^32, 精度最多9位, 按四舍五入舍入;
+ *       无递归, 栈用量有上界(不含打印流的写入函数, memcpy, strlen 与64位除法等库函数):
+ *       GCC 12.2 -m32(i386) 下以 -fcallgraph-info=su 统计, 最深的调用链为
+ *       fmt_printf -> fmt_vprintf -> fmt_out_integer -> fmt_out_field -> fmt_out_string -> fmt_write,
+ *       -O2 时为496字节, -Os 时为540字节; 异步模式BLOCK策略等待空间时再经 eventflags_wait,
+ *       -O2 时为632字节, -Os 时为636字节; 其他编译器与目标(如 arm-none-eabi-gcc)按同样的方法统计
  */
 void fmt_printf(const char *format, ...);
 
+/**
+ * @brief 格式化打印
+ * @param format 格式字符串
+ * @param args 参数列表
+ */
+void fmt_vprintf(const char *format, va_list args);
+
+/**
+ * @brief 将异步缓冲区中已提交的数据全部写入打印流
+ * @note 同步模式下无作用; 同一时刻只能有一个发送者
+ */
+void fmt_flush(void);
+
+/**
+ * @brief 异步输出任务函数, 有数据提交时写入打印流
+ * @param arg 未使用
+ * @note 可作为 task_create 的任务函数, 通常使用较低的优先级
+ */
+void fmt_drain_task(void *arg);
+
+/**
+ * @brief 获取异步缓冲区中已提交且连续的待发送数据
+ * @param data 待发送数据的起始地址
+ * @return 待发送数据的长度
+ * @note 用于DMA发送, 发送完成后调用 fmt_async_consume; 取走的数据在释放之前不会被覆盖,
+ *       释放之前再次调用返回同一段数据
+ */
+size_t fmt_async_get_pending(const char **const data);
+
+/**
+ * @brief 释放已发送的数据
+ * @param length 已发送数据的长度(不超过 fmt_async_get_pending 返回的长度)
+ * @note 中断安全
+ */
+void fmt_async_consume(const size_t length);
+
+/**
+ * @brief 获取异步模式下被丢弃的输出数量
+ * @return 被丢弃的输出条数, 包括OVERWRITE策略下被覆盖的输出
+ */
+size_t fmt_async_get_dropped(void);
+
 #endif /* _ZHIYEC_FMT_H */
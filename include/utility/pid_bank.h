@@ -0,0 +1,67 @@
+/**
+ * @file pid_bank.h
+ * @author Zhiyelah
+ * @brief PID控制器组
+ * @note 以数组形式保存同一采样频率的多个定点PID控制器, 一次调用更新所有控制器;
+ *       目标值、测量值和输出为Q15, 积分为Q31; 微分项只对测量值求导, 积分使用钳位抗饱和;
+ *       带DSP扩展的内核(Cortex-M4/M7)上每次用SIMD指令计算两个控制器
+ */
+
+#ifndef _PID_BANK_H
+#define _PID_BANK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 将常量增益转换为增益数组中的值
+ * @param gain 增益
+ * @param gain_shift 增益的放大位数, 见 struct pid_bank
+ */
+#define PIDBANK_GAIN(gain, gain_shift)                                                                     \
+    ((int16_t)(((gain) * 32768.0 / (1L << (gain_shift))) >= 32767.0    ? 32767                              \
+               : ((gain) * 32768.0 / (1L << (gain_shift))) <= -32767.0 ? -32767                             \
+                                                                       : (gain) * 32768.0 / (1L << (gain_shift))))
+
+struct pid_bank {
+    /* 控制器数量 */
+    size_t count;
+
+    /* 增益(Q15, 实际增益为数组中的值乘以 2^gain_shift, 范围为[-32767, 32767]) */
+    const int16_t *kp;
+    /* 积分增益乘采样周期 */
+    const int16_t *ki;
+    /* 微分增益除以采样周期 */
+    const int16_t *kd;
+    /* 增益的放大位数, 所有增益相同 */
+    uint8_t gain_shift;
+
+    /* 输出范围(Q15) */
+    const int16_t *output_min;
+    const int16_t *output_max;
+
+    /* 积分项(Q31) */
+    int32_t *integral;
+    /* 上一次测量值 */
+    int16_t *prev_measurement;
+};
+
+/**
+ * @brief 清除所有控制器的积分和微分状态
+ * @param bank 控制器组, 需先填写所有数组
+ * @param measurement 当前测量值(可为NULL, 为NULL时以0作为下一次微分的起点)
+ */
+void pid_bank_reset(struct pid_bank *const bank, const int16_t *const measurement);
+
+/**
+ * @brief 计算所有控制器
+ * @param bank 控制器组
+ * @param setpoint 目标值数组
+ * @param measurement 测量值数组
+ * @param output 输出数组, 已限幅
+ * @note 每个采样周期调用一次
+ */
+void pid_bank_update(struct pid_bank *const bank, const int16_t *const setpoint,
+                     const int16_t *const measurement, int16_t *const output);
+
+#endif /* _PID_BANK_H */
@@ -0,0 +1,84 @@
+/**
+ * @file pid_fixed.h
+ * @author Zhiyelah
+ * @brief 定点PID控制器
+ * @note 用于没有FPU的内核: 目标值、测量值和输出为Q15, 内部状态为Q31, 增益为Q16.16;
+ *       增益在初始化时按固定的采样周期预先计算, 计算输出时没有浮点运算和除法;
+ *       输出限幅并带积分抗饱和, 微分项只对测量值求导(目标值突变时没有微分冲击)并经过一阶低通滤波
+ */
+
+#ifndef _PID_FIXED_H
+#define _PID_FIXED_H
+
+#include <stdint.h>
+
+struct pid_fixed;
+
+#define PIDFIXED_BYTE 44
+
+/**
+ * @brief 将常量转换为Q15
+ * @param x 常量, 范围为[-1, 1)
+ */
+#define PIDFIXED_Q15(x) ((int16_t)((x) >= 1.0 ? INT16_MAX : (x) * 32768.0))
+
+/* 积分抗饱和方式 */
+enum pid_fixed_antiwindup {
+    /* 钳位: 输出饱和且误差使其更加饱和时停止积分 */
+    PIDFIXED_ANTIWINDUP_CLAMP,
+    /* 反馈计算: 按饱和量以 dt / tt 的比例修正积分 */
+    PIDFIXED_ANTIWINDUP_BACK_CALCULATION,
+};
+
+struct pid_fixed_config {
+    /* PID参数, 输入和输出均为Q15时的增益(不超过32767) */
+    float kp;
+    float ki;
+    float kd;
+    /* 采样周期, 单位: 秒 */
+    float dt;
+    /* 微分低通滤波时间常数, 单位: 秒(为0时不滤波) */
+    float tf;
+    /* 输出范围(Q15) */
+    int16_t output_min;
+    int16_t output_max;
+    /* 积分抗饱和方式 */
+    enum pid_fixed_antiwindup antiwindup;
+    /* 反馈计算的跟踪时间常数, 单位: 秒(只用于 PIDFIXED_ANTIWINDUP_BACK_CALCULATION) */
+    float tt;
+};
+
+/**
+ * @brief 初始化定点PID控制器
+ * @param pid_mem 对象内存指针
+ * @param config 参数, 只在初始化时使用
+ * @return 对象指针
+ * @note 只在初始化时使用浮点运算
+ */
+struct pid_fixed *pid_fixed_init(void *const pid_mem, const struct pid_fixed_config *const config);
+
+/**
+ * @brief 清除积分和微分状态
+ * @param pid PID对象
+ * @param measurement 当前测量值(Q15), 作为下一次微分的起点
+ */
+void pid_fixed_reset(struct pid_fixed *const pid, const int16_t measurement);
+
+/**
+ * @brief 计算PID
+ * @param pid PID对象
+ * @param setpoint 目标值(Q15)
+ * @param measurement 测量值(Q15)
+ * @return PID输出(Q15), 已限幅
+ * @note 每个采样周期调用一次
+ */
+int16_t pid_fixed_cal_output(struct pid_fixed *const pid, const int16_t setpoint, const int16_t measurement);
+
+/**
+ * @brief 获取PID输出
+ * @param pid PID对象
+ * @return PID输出(Q15)
+ */
+int16_t pid_fixed_get_output(const struct pid_fixed *const pid);
+
+#endif /* _PID_FIXED_H */
@@ -0,0 +1,59 @@
+/**
+ * @file arena.h
+ * @author Zhiyelah
+ * @brief 区域分配器
+ * @note 可选的模块, 依赖动态内存分配;
+ *       从堆中一次分配一整块内存, 之后的分配只移动指针, 不加锁, 也不能单独释放, 需通过重置或销毁统一释放;
+ *       同一个区域分配器不能在多个任务中同时使用
+ */
+
+#ifndef _ZHIYEC_ARENA_H
+#define _ZHIYEC_ARENA_H
+
+#include <stddef.h>
+
+struct arena;
+
+/**
+ * @brief 创建区域分配器
+ * @param size 可分配的内存大小
+ * @return 对象指针, 失败返回NULL
+ */
+struct arena *arena_create(const size_t size);
+
+/**
+ * @brief 创建属于当前任务的区域分配器
+ * @param size 可分配的内存大小
+ * @return 对象指针, 失败返回NULL
+ * @note 任务被删除时若未销毁, 由空闲任务自动释放
+ */
+struct arena *arena_create_task_owned(const size_t size);
+
+/**
+ * @brief 从区域分配器中分配内存
+ * @param arena 区域分配器对象
+ * @param size 分配的内存大小
+ * @return 内存指针(按 BYTE_ALIGNMENT 对齐), 空间不足返回NULL
+ */
+void *arena_alloc(struct arena *const arena, const size_t size);
+
+/**
+ * @brief 重置区域分配器, 释放所有已分配的内存
+ * @param arena 区域分配器对象
+ */
+void arena_reset(struct arena *const arena);
+
+/**
+ * @brief 销毁区域分配器, 将内存归还给堆
+ * @param arena 区域分配器对象
+ */
+void arena_destroy(struct arena *const arena);
+
+/**
+ * @brief 获取剩余可分配的内存大小
+ * @param arena 区域分配器对象
+ * @return 剩余可分配的内存大小
+ */
+size_t arena_get_free_size(const struct arena *const arena);
+
+#endif /* _ZHIYEC_ARENA_H */
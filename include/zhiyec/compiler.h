@@ -6,16 +6,38 @@
 #define section(x) __attribute__((section(x)))
 #define typeof __typeof__
 #define used __attribute__((used))
+#define aligned(x) __attribute__((aligned(x)))
+#define return_address() __builtin_return_address(0)
 #elif defined(__ARMCC_VERSION)
 #define always_inline __forceinline
 #define section(x) __attribute__((section(x)))
 #define typeof __typeof
 #define used __attribute__((used))
+#define aligned(x) __attribute__((aligned(x)))
+#define return_address() ((void *)__return_address())
 #else
 #define always_inline
 #define section(x)
 #define typeof
 #define used
+#define aligned(x)
+#define return_address() ((void *)0)
+#endif
+
+/* 计算前导零的个数(参数不能为0) */
+#if defined(__GNUC__)
+#define count_leading_zeros(x) ((unsigned int)__builtin_clz(x))
+#elif defined(__ARMCC_VERSION)
+#define count_leading_zeros(x) ((unsigned int)__clz(x))
+#else
+static inline unsigned int count_leading_zeros(unsigned int x) {
+    unsigned int n = 0U;
+    while (!(x & 0x80000000U)) {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+}
 #endif
 
 #if defined(__ARMCC_VERSION)
@@ -28,4 +50,13 @@
 #define DMB()
 #endif
 
+/* 编译器屏障, 禁止编译器跨越屏障重排内存访问 */
+#if defined(__GNUC__)
+#define compiler_barrier() __asm__ volatile("" ::: "memory")
+#elif defined(__ARMCC_VERSION)
+#define compiler_barrier() __schedule_barrier()
+#else
+#define compiler_barrier()
+#endif
+
 #endif /* _ZHIYEC_COMPILER_H */
@@ -0,0 +1,112 @@
+/**
+ * @file event_flags.h
+ * @author Zhiyelah
+ * @brief 事件标志
+ * @note 可选的模块, 32个由用户定义的事件位, 每个等待者可指定各自的掩码与等待条件
+ */
+
+#ifndef _ZHIYEC_EVENTFLAGS_H
+#define _ZHIYEC_EVENTFLAGS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zhiyec/tick.h>
+
+enum eventflags_option {
+    /* 掩码中任一位被置位时满足条件 */
+    EVENTFLAGS_WAIT_ANY = 0x00U,
+    /* 掩码中所有位均被置位时满足条件 */
+    EVENTFLAGS_WAIT_ALL = 0x01U,
+    /* 满足条件后清除掩码中的位 */
+    EVENTFLAGS_CLEAR_ON_EXIT = 0x02U,
+};
+
+struct eventflags;
+
+#define EVENTFLAGS_BYTE 12
+
+/**
+ * @brief 初始化事件标志
+ * @param event_flags_mem 对象内存指针
+ * @param init_flags 初始事件位
+ * @return 对象指针
+ */
+struct eventflags *eventflags_init(void *const event_flags_mem, const uint32_t init_flags);
+
+/**
+ * @brief 等待事件, 条件不满足时当前任务进入阻塞
+ * @param event_flags 事件标志对象
+ * @param mask 等待的事件位
+ * @param options 等待选项, 可以是下列选项的组合:
+ *          EVENTFLAGS_WAIT_ANY 或 EVENTFLAGS_WAIT_ALL,
+ *          EVENTFLAGS_CLEAR_ON_EXIT
+ * @return 满足条件时的事件位(清除前)
+ */
+uint32_t eventflags_wait(struct eventflags *const event_flags, const uint32_t mask, const uint32_t options);
+
+/**
+ * @brief 尝试等待事件, 超时直接返回失败
+ * @param event_flags 事件标志对象
+ * @param mask 等待的事件位
+ * @param options 等待选项
+ * @param flags 满足条件时的事件位(清除前), 可为NULL
+ * @param timeout 超时时间
+ * @return 是否满足条件
+ */
+bool eventflags_try_wait(struct eventflags *const event_flags, const uint32_t mask, const uint32_t options,
+                         uint32_t *const flags, const tick_t timeout);
+
+/**
+ * @brief 置位事件, 并唤醒条件已满足的等待者
+ * @param event_flags 事件标志对象
+ * @param flags 置位的事件位
+ * @return 置位后的事件位(等待者清除后)
+ */
+uint32_t eventflags_set(struct eventflags *const event_flags, const uint32_t flags);
+
+/**
+ * @brief 置位事件, 并唤醒条件已满足的等待者
+ * @param event_flags 事件标志对象
+ * @param flags 置位的事件位
+ * @return 置位后的事件位(等待者清除后)
+ * @note 中断安全的版本
+ */
+uint32_t eventflags_set_from_isr(struct eventflags *const event_flags, const uint32_t flags);
+
+/**
+ * @brief 清除事件
+ * @param event_flags 事件标志对象
+ * @param flags 清除的事件位
+ * @return 清除前的事件位
+ */
+uint32_t eventflags_clear(struct eventflags *const event_flags, const uint32_t flags);
+
+/**
+ * @brief 获取事件位
+ * @param event_flags 事件标志对象
+ * @return 当前的事件位
+ */
+uint32_t eventflags_get(const struct eventflags *const event_flags);
+
+/**
+ * @brief 同步点: 置位事件后等待所有参与者到达
+ * @param event_flags 事件标志对象
+ * @param flags 当前任务置位的事件位
+ * @param wait_flags 所有参与者的事件位, 全部置位后清除并返回
+ * @return 满足条件时的事件位(清除前)
+ */
+uint32_t eventflags_sync(struct eventflags *const event_flags, const uint32_t flags, const uint32_t wait_flags);
+
+/**
+ * @brief 同步点: 置位事件后等待所有参与者到达, 超时直接返回失败
+ * @param event_flags 事件标志对象
+ * @param flags 当前任务置位的事件位
+ * @param wait_flags 所有参与者的事件位
+ * @param timeout 超时时间
+ * @return 是否所有参与者都已到达
+ */
+bool eventflags_try_sync(struct eventflags *const event_flags, const uint32_t flags, const uint32_t wait_flags,
+                         const tick_t timeout);
+
+#endif /* _ZHIYEC_EVENTFLAGS_H */
@@ -0,0 +1,67 @@
+/**
+ * @file kobject.h
+ * @author Zhiyelah
+ * @brief 内核对象注册
+ * @note 可选的模块, 依赖内核信息查询; 注册后可通过 kobject_get_snapshot 查询对象的使用情况,
+ *       对象只能注册, 不能注销; 对象的信息由所属模块的 xxx_get_kobject_info 函数提供
+ */
+
+#ifndef _ZHIYEC_KOBJECT_H
+#define _ZHIYEC_KOBJECT_H
+
+#include <stddef.h>
+
+struct kobject_info {
+    /* 对象名称 */
+    const char *name;
+    /* 类型名称 */
+    const char *type;
+    /* 当前值(信号量计数值、队列消息数、事件位、已分配的内存块数) */
+    size_t value;
+    /* 容量, 为0时表示无容量 */
+    size_t capacity;
+    /* 等待的任务数 */
+    size_t waiting_count;
+};
+
+struct kobject;
+
+#define KOBJECT_BYTE 16
+
+/**
+ * @brief 注册内核对象
+ * @param kobject_mem 注册节点内存指针, 需在对象的整个生命周期内有效
+ * @param name 对象名称
+ * @param object 内核对象
+ * @param get_info 获取对象信息的函数
+ * @note 线程安全
+ */
+void kobject_register(void *const kobject_mem, const char *const name, const void *const object,
+                      void (*const get_info)(const void *, struct kobject_info *));
+
+/* 注册各类内核对象 */
+#define kobject_register_semaphore(kobject_mem, name, sem) \
+    kobject_register((kobject_mem), (name), (sem), semaphore_get_kobject_info)
+#define kobject_register_msgqueue(kobject_mem, name, msg_queue) \
+    kobject_register((kobject_mem), (name), (msg_queue), msgqueue_get_kobject_info)
+#define kobject_register_eventflags(kobject_mem, name, event_flags) \
+    kobject_register((kobject_mem), (name), (event_flags), eventflags_get_kobject_info)
+#define kobject_register_mempool(kobject_mem, name, mem_pool) \
+    kobject_register((kobject_mem), (name), (mem_pool), mempool_get_kobject_info)
+
+/**
+ * @brief 获取所有已注册对象的信息
+ * @param infos 对象信息数组
+ * @param max_count 数组大小
+ * @return 写入的对象信息数量
+ * @note 每个对象的信息在短暂屏蔽中断时获取, 不可在中断中调用
+ */
+size_t kobject_get_snapshot(struct kobject_info *const infos, const size_t max_count);
+
+/* 各模块提供的对象信息函数 */
+void semaphore_get_kobject_info(const void *object, struct kobject_info *info);
+void msgqueue_get_kobject_info(const void *object, struct kobject_info *info);
+void eventflags_get_kobject_info(const void *object, struct kobject_info *info);
+void mempool_get_kobject_info(const void *object, struct kobject_info *info);
+
+#endif /* _ZHIYEC_KOBJECT_H */
@@ -0,0 +1,88 @@
+/**
+ * @file mem_pool.h
+ * @author Zhiyelah
+ * @brief 固定大小内存块池
+ * @note 可选的模块, 不依赖动态内存分配; 分配和释放均为O(1), 可在任务和中断中调用
+ */
+
+#ifndef _ZHIYEC_MEMPOOL_H
+#define _ZHIYEC_MEMPOOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zhiyec/tick.h>
+
+struct mempool;
+
+#define MEMPOOL_BYTE 28
+
+/**
+ * @brief 计算内存块实际占用的大小(按指针大小对齐, 且不小于一个指针)
+ * @param block_size 内存块大小
+ */
+#define MEMPOOL_BLOCK_SIZE(block_size)                                                        \
+    (((((block_size) < sizeof(void *)) ? sizeof(void *) : (block_size)) + (sizeof(void *) - 1U)) & \
+     ~(sizeof(void *) - 1U))
+
+/**
+ * @brief 计算内存池所需的内存大小
+ * @param block_size 内存块大小
+ * @param count 内存块数量
+ */
+#define MEMPOOL_MEM_SIZE(block_size, count) (MEMPOOL_BLOCK_SIZE(block_size) * (count))
+
+struct mempool_stats {
+    /* 内存块大小 */
+    size_t block_size;
+    /* 内存块数量 */
+    size_t block_count;
+    /* 当前空闲的内存块数量 */
+    size_t free_count;
+    /* 历史最少空闲的内存块数量 */
+    size_t min_free_count;
+    /* 分配失败次数 */
+    size_t failed_count;
+};
+
+/**
+ * @brief 初始化内存池
+ * @param mem_pool_mem 对象内存指针
+ * @param mem 内存块所在的内存, 大小至少为 MEMPOOL_MEM_SIZE(block_size, count), 需按指针大小对齐
+ * @param block_size 内存块大小
+ * @param count 内存块数量
+ * @return 对象指针
+ */
+struct mempool *mempool_init(void *const mem_pool_mem, void *const mem, const size_t block_size, const size_t count);
+
+/**
+ * @brief 分配内存块, 没有空闲块时立即返回
+ * @param mem_pool 内存池对象
+ * @return 内存块指针, 失败返回NULL
+ * @note 中断安全
+ */
+void *mempool_alloc(struct mempool *const mem_pool);
+
+/**
+ * @brief 尝试分配内存块, 没有空闲块时等待, 超时直接返回
+ * @param mem_pool 内存池对象
+ * @param timeout 超时时间
+ * @return 内存块指针, 超时返回NULL
+ */
+void *mempool_try_alloc(struct mempool *const mem_pool, const tick_t timeout);
+
+/**
+ * @brief 释放内存块
+ * @param mem_pool 内存池对象
+ * @param ptr 通过 mempool_alloc 分配的内存块指针
+ * @note 中断安全
+ */
+void mempool_free(struct mempool *const mem_pool, void *const ptr);
+
+/**
+ * @brief 获取内存池统计信息
+ * @param mem_pool 内存池对象
+ * @param stats 统计信息
+ */
+void mempool_get_stats(const struct mempool *const mem_pool, struct mempool_stats *const stats);
+
+#endif /* _ZHIYEC_MEMPOOL_H */
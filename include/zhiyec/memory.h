@@ -8,7 +8,20 @@
 #ifndef _ZHIYEC_MEMORY_H
 #define _ZHIYEC_MEMORY_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <zhiyec/types.h>
+
+/* 内存区域属性 */
+enum memory_region_flag {
+    /* 零等待的内存(CCM, DTCM等), 适合放置频繁访问的数据 */
+    MEMORY_REGION_FAST = 0x01U,
+    /* DMA可访问的内存 */
+    MEMORY_REGION_DMA = 0x02U,
+    /* 分配的内存按缓存行对齐且独占缓存行, 用于带数据缓存时的DMA缓冲区 */
+    MEMORY_REGION_CACHE_ALIGNED = 0x04U,
+};
 
 /**
  * @brief 分配内存
@@ -16,16 +29,83 @@
  */
 void *memory_alloc(size_t size);
 
+/**
+ * @brief 在指定属性的内存区域中分配内存
+ * @param region_flags 内存区域需具备的属性, 为0时可在任意区域中分配
+ * @param size 分配的内存大小
+ * @param align 对齐大小, 必须是2的幂, 为0时使用默认对齐
+ * @return 内存指针, 失败返回NULL
+ * @note 按添加顺序依次尝试满足属性的区域, 内存池总是第一个区域
+ */
+void *memory_alloc_in(const uint32_t region_flags, const size_t size, const size_t align);
+
+/**
+ * @brief 添加内存区域
+ * @param mem 内存区域起始地址
+ * @param size 内存区域大小
+ * @param region_flags 内存区域属性
+ * @return 是否添加成功
+ */
+bool memory_add_region(void *const mem, const size_t size, const uint32_t region_flags);
+
 /**
  * @brief 释放内存
- * @param ptr 通过Memory_alloc分配的内存指针
+ * @param ptr 通过 memory_alloc 或 memory_alloc_in 分配的内存指针
  */
 void memory_free(void *const ptr);
 
 /**
  * @brief 获取空闲内存大小
- * @return 空闲内存大小
+ * @return 所有内存区域的空闲内存大小
  */
 size_t memory_get_free_size(void);
 
+struct memory_stats {
+    /* 空闲内存大小 */
+    size_t free_size;
+    /* 历史最少空闲内存大小 */
+    size_t min_ever_free_size;
+    /* 最大空闲块大小(单次可分配的上限) */
+    size_t largest_free_block;
+    /* 空闲块数量(碎片数) */
+    size_t free_block_count;
+    /* 成功分配次数 */
+    size_t alloc_count;
+    /* 释放次数 */
+    size_t free_count;
+    /* 分配失败次数 */
+    size_t failed_alloc_count;
+};
+
+/**
+ * @brief 获取堆统计信息
+ * @param stats 所有内存区域汇总的统计信息
+ */
+void memory_get_stats(struct memory_stats *const stats);
+
+/**
+ * 内存分配跟踪记录
+ * 主机端工具 tools/heap_trace.py 按每行"时间戳 调用者 指针 大小"的文本格式读取记录,
+ * 生成碎片时间线与泄漏报告
+ */
+struct memory_trace_record {
+    /* 时间戳(Tick) */
+    tick_t timestamp;
+    /* 调用者地址 */
+    void *caller;
+    /* 内存指针, 分配失败时为NULL */
+    void *ptr;
+    /* 分配大小, 为0时表示释放 */
+    size_t size;
+};
+
+/**
+ * @brief 复制内存分配跟踪记录
+ * @param records 记录存放缓冲区
+ * @param max_count 缓冲区可存放的记录数
+ * @return 复制的记录数, 按时间从旧到新排列
+ * @note 需在配置文件中启用内存分配跟踪
+ */
+size_t memory_trace_copy(struct memory_trace_record *const records, const size_t max_count);
+
 #endif /* _ZHIYEC_MEMORY_H */
@@ -0,0 +1,100 @@
+/**
+ * @file msg_buffer.h
+ * @author Zhiyelah
+ * @brief 消息缓冲区
+ * @note 可选的模块, 以"长度前缀 + 数据"的形式在字节环形缓冲区中连续存放变长消息
+ */
+
+#ifndef _ZHIYEC_MSGBUFFER_H
+#define _ZHIYEC_MSGBUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zhiyec/tick.h>
+
+struct msgbuffer;
+
+#define MSGBUFFER_BYTE 36
+
+/* 每条消息长度前缀占用的字节数 */
+#define MSGBUFFER_LENGTH_BYTE (sizeof(uint16_t))
+
+/* 单条消息的最大长度 */
+#define MSGBUFFER_MSG_MAX_SIZE 0xFFFFU
+
+/**
+ * @brief 初始化消息缓冲区
+ * @param msg_buffer_mem 对象内存指针
+ * @param buffer 字节缓冲区
+ * @param buffer_size 缓冲区大小(单位: 字节)
+ * @param trigger_level 触发等级, 缓冲区中的字节数达到该值时才唤醒阻塞的接收任务(最小为1)
+ * @return 对象指针
+ */
+struct msgbuffer *msgbuffer_init(void *const msg_buffer_mem,
+                                 void *const buffer, const size_t buffer_size, const size_t trigger_level);
+
+/**
+ * @brief 发送消息, 缓冲区空间不足时当前任务进入阻塞
+ * @param msg_buffer 消息缓冲区对象
+ * @param data 消息内容
+ * @param len 消息长度
+ * @return 是否发送成功(消息长度为0或超出缓冲区容量时失败)
+ */
+bool msgbuffer_send(struct msgbuffer *const msg_buffer, const void *const data, const size_t len);
+
+/**
+ * @brief 发送消息
+ * @param msg_buffer 消息缓冲区对象
+ * @param data 消息内容
+ * @param len 消息长度
+ * @return 是否发送成功
+ * @note 中断安全的版本
+ */
+bool msgbuffer_send_from_isr(struct msgbuffer *const msg_buffer, const void *const data, const size_t len);
+
+/**
+ * @brief 接收消息, 缓冲区为空时当前任务进入阻塞
+ * @param msg_buffer 消息缓冲区对象
+ * @param data 消息存放缓冲区
+ * @param max_len 消息存放缓冲区大小
+ * @return 消息长度; 存放缓冲区不足以容纳下一条消息时返回0, 且消息保留在缓冲区中
+ */
+size_t msgbuffer_receive(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len);
+
+/**
+ * @brief 尝试接收消息, 超时直接返回
+ * @param msg_buffer 消息缓冲区对象
+ * @param data 消息存放缓冲区
+ * @param max_len 消息存放缓冲区大小
+ * @param timeout 超时时间
+ * @return 消息长度, 超时返回0
+ */
+size_t msgbuffer_try_receive(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len,
+                             const tick_t timeout);
+
+/**
+ * @brief 接收消息
+ * @param msg_buffer 消息缓冲区对象
+ * @param data 消息存放缓冲区
+ * @param max_len 消息存放缓冲区大小
+ * @return 消息长度, 没有消息时返回0
+ * @note 中断安全的版本
+ */
+size_t msgbuffer_receive_from_isr(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len);
+
+/**
+ * @brief 获取下一条消息的长度
+ * @param msg_buffer 消息缓冲区对象
+ * @return 消息长度, 没有消息时返回0
+ */
+size_t msgbuffer_get_next_length(struct msgbuffer *const msg_buffer);
+
+/**
+ * @brief 获取空闲空间大小
+ * @param msg_buffer 消息缓冲区对象
+ * @return 空闲字节数(含长度前缀的开销)
+ */
+size_t msgbuffer_get_free_size(const struct msgbuffer *const msg_buffer);
+
+#endif /* _ZHIYEC_MSGBUFFER_H */
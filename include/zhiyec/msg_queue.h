@@ -10,18 +10,48 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/list.h>
 #include <zhiyec/tick.h>
 
-struct msgqueue;
+#if (USE_QUEUE_SET)
+struct queueset;
+#endif /* USE_QUEUE_SET */
 
-#define MSGQUEUE_BYTE 36
+struct msgqueue {
+    /* 数据缓冲区 */
+    void *buffer;
+    /* 缓冲区大小(单位: 消息个数) */
+    size_t buffer_size;
+    /* 类型大小 */
+    size_t type_size;
+    /* 等待发送消息的任务 */
+    struct stack_list tasks_waiting_to_send;
+    /* 等待接收消息的任务 */
+    struct stack_list tasks_waiting_to_receive;
+    /* 等待接收消息的任务数 */
+    volatile size_t task_waiting_to_receive_count;
+
+    /* 队头指针（出队位置） */
+    size_t queue_head;
+    /* 队尾指针（入队位置） */
+    size_t queue_tail;
+    /* 当前队列元素数量 */
+    volatile size_t queue_count;
+#if (USE_QUEUE_SET)
+    /* 所属的队列集合 */
+    struct queueset *queue_set;
+#endif /* USE_QUEUE_SET */
+};
+
+#define MSGQUEUE_BYTE (sizeof(struct msgqueue))
 
 /**
  * @brief 初始化消息队列
  * @param msg_queue_mem 对象内存指针
  * @param type_size 消息数据类型大小
  * @param buffer 消息缓冲区
- * @param buffer_size 缓冲区大小
+ * @param buffer_size 缓冲区大小(单位: 消息个数)
  * @return 对象指针
  */
 struct msgqueue *msgqueue_init(void *const msg_queue_mem,
@@ -62,4 +92,124 @@ void msgqueue_receive(struct msgqueue *const msg_queue, void *const data);
 bool msgqueue_try_receive(struct msgqueue *const msg_queue, void *const data,
                           const tick_t timeout);
 
+/* 以下为 MSGQUEUE_DEFINE 生成的类型化函数所使用的内部接口, 不建议直接调用 */
+
+/* 检查队列是否为空 */
+#define msgqueue_is_empty(msg_queue) ((msg_queue)->queue_count == 0)
+
+/* 检查队列是否已满 */
+#define msgqueue_is_full(msg_queue) ((msg_queue)->queue_count == (msg_queue)->buffer_size)
+
+/**
+ * @brief 计算环形缓冲区的下一个位置
+ * @note capacity为编译期常量时不产生除法; 为2的幂时使用掩码
+ */
+#define msgqueue_next_index(index, capacity)                                   \
+    ((((capacity) & ((capacity) - 1U)) == 0U)                                  \
+         ? (((index) + 1U) & ((capacity) - 1U))                                \
+         : (((index) + 1U == (capacity)) ? (size_t)0U : ((index) + 1U)))
+
+/**
+ * @brief 等待队列出现空位, 队列已满时当前任务进入阻塞
+ * @note 返回时中断处于屏蔽状态, 写入消息后需调用 msgqueue_commit_send() 和 atomic_end()
+ */
+void msgqueue_wait_to_send(struct msgqueue *const msg_queue);
+
+/**
+ * @brief 提交已写入队尾的消息, 并唤醒等待接收消息的任务
+ * @param next_tail 新的队尾位置
+ * @note 需在屏蔽中断时调用
+ */
+void msgqueue_commit_send(struct msgqueue *const msg_queue, const size_t next_tail);
+
+/**
+ * @brief 等待队列中出现消息
+ * @return 是否等到消息; 返回true时调度器已暂停, 读取消息后需调用 msgqueue_commit_receive()
+ */
+bool msgqueue_wait_to_receive(struct msgqueue *const msg_queue, const bool has_timeout, tick_t timeout);
+
+/**
+ * @brief 提交对队头消息的读取, 并恢复调度器
+ * @param next_head 新的队头位置
+ */
+void msgqueue_commit_receive(struct msgqueue *const msg_queue, const size_t next_head);
+
+/* 静态初始化时所属的队列集合 */
+#if (USE_QUEUE_SET)
+#define MSGQUEUE_INITIALIZER_QUEUE_SET .queue_set = NULL,
+#else
+#define MSGQUEUE_INITIALIZER_QUEUE_SET
+#endif /* USE_QUEUE_SET */
+
+/**
+ * @brief 消息队列静态初始化器
+ * @param buffer 消息缓冲区
+ * @param type_size 消息数据类型大小
+ * @param capacity 缓冲区大小(单位: 消息个数)
+ */
+#define MSGQUEUE_INITIALIZER(buffer_, type_size_, capacity) \
+    {                                                       \
+        .buffer = (buffer_),                                \
+        .buffer_size = (capacity),                          \
+        .type_size = (type_size_),                          \
+        .tasks_waiting_to_send = {NULL},                    \
+        .tasks_waiting_to_receive = {NULL},                 \
+        .task_waiting_to_receive_count = 0U,                \
+        .queue_head = 0U,                                   \
+        .queue_tail = 0U,                                   \
+        .queue_count = 0U,                                  \
+        MSGQUEUE_INITIALIZER_QUEUE_SET                      \
+    }
+
+/**
+ * @brief 定义静态分配并初始化的类型化消息队列(在文件作用域使用)
+ * @param name 队列名称, 同时是指向队列对象的指针, 可用于通用的 msgqueue_* 接口
+ * @param type 消息数据类型
+ * @param capacity 队列容量(单位: 消息个数), 为2的幂时使用掩码计算位置
+ * @note 同时生成以下函数, 消息大小为编译期常量, 以结构体赋值代替memcpy:
+ *      bool name_send(const type *data);
+ *      bool name_send_from_isr(const type *data);
+ *      void name_receive(type *data);
+ *      bool name_try_receive(type *data, tick_t timeout);
+ */
+#define MSGQUEUE_DEFINE(name, type, capacity)                                                                    \
+    static type name##_buffer[(capacity)];                                                                      \
+    static struct msgqueue name##_object = MSGQUEUE_INITIALIZER(name##_buffer, sizeof(type), (capacity));        \
+    static struct msgqueue *const name = &name##_object;                                                         \
+                                                                                                                 \
+    static inline bool name##_send(const type *const data) {                                                     \
+        msgqueue_wait_to_send(name);                                                                             \
+        name##_buffer[name->queue_tail] = *data;                                                                 \
+        msgqueue_commit_send(name, msgqueue_next_index(name->queue_tail, (size_t)(capacity)));                   \
+        atomic_end();                                                                                            \
+        return true;                                                                                             \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline bool name##_send_from_isr(const type *const data) {                                            \
+        bool is_sent = false;                                                                                    \
+        uint32_t prev_basepri = irq_disable_from_isr();                                                          \
+        if (!msgqueue_is_full(name)) {                                                                           \
+            name##_buffer[name->queue_tail] = *data;                                                             \
+            msgqueue_commit_send(name, msgqueue_next_index(name->queue_tail, (size_t)(capacity)));               \
+            is_sent = true;                                                                                      \
+        }                                                                                                        \
+        irq_enable_from_isr(prev_basepri);                                                                       \
+        return is_sent;                                                                                          \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline void name##_receive(type *const data) {                                                        \
+        (void)msgqueue_wait_to_receive(name, false, 0);                                                          \
+        *data = name##_buffer[name->queue_head];                                                                 \
+        msgqueue_commit_receive(name, msgqueue_next_index(name->queue_head, (size_t)(capacity)));                \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline bool name##_try_receive(type *const data, const tick_t timeout) {                              \
+        if (!msgqueue_wait_to_receive(name, true, timeout)) {                                                    \
+            return false;                                                                                        \
+        }                                                                                                        \
+        *data = name##_buffer[name->queue_head];                                                                 \
+        msgqueue_commit_receive(name, msgqueue_next_index(name->queue_head, (size_t)(capacity)));                \
+        return true;                                                                                             \
+    }
+
 #endif /* _ZHIYEC_MSGQUEUE_H */
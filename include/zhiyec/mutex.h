@@ -14,7 +14,11 @@
 
 struct mutex;
 
+#if (USE_QUEUE_SET)
+#define MUTEX_BYTE 32
+#else
 #define MUTEX_BYTE 28
+#endif /* USE_QUEUE_SET */
 
 /**
  * @brief 初始化互斥锁
@@ -0,0 +1,81 @@
+/**
+ * @file queue_set.h
+ * @author Zhiyelah
+ * @brief 队列集合
+ * @note 可选的模块, 在配置文件中启用队列集合功能后添加;
+ *       可同时等待多个消息队列和信号量, 返回就绪的对象后再对该对象进行非阻塞的接收或获取
+ */
+
+#ifndef _ZHIYEC_QUEUESET_H
+#define _ZHIYEC_QUEUESET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zhiyec/msg_queue.h>
+#include <zhiyec/semaphore.h>
+#include <zhiyec/tick.h>
+
+struct queueset;
+
+#define QUEUESET_BYTE 36
+
+/**
+ * @brief 初始化队列集合
+ * @param queue_set_mem 对象内存指针
+ * @param buffer 就绪事件缓冲区
+ * @param buffer_size 缓冲区大小, 所有成员容量之和(消息队列的容量与信号量的最大计数值)不能超过该大小
+ * @return 对象指针
+ */
+struct queueset *queueset_init(void *const queue_set_mem, void **const buffer, const size_t buffer_size);
+
+/**
+ * @brief 将消息队列加入集合
+ * @param queue_set 队列集合对象
+ * @param msg_queue 消息队列对象
+ * @return 是否加入成功(一个对象只能属于一个集合, 加入后成员容量之和不能超过缓冲区大小)
+ * @note 队列中已有的消息会立即成为就绪事件
+ */
+bool queueset_add_msgqueue(struct queueset *const queue_set, struct msgqueue *const msg_queue);
+
+/**
+ * @brief 将信号量加入集合
+ * @param queue_set 队列集合对象
+ * @param sem 信号量对象
+ * @return 是否加入成功(一个对象只能属于一个集合, 加入后成员容量之和不能超过缓冲区大小)
+ * @note 信号量当前可获得的计数会立即成为就绪事件
+ */
+bool queueset_add_semaphore(struct queueset *const queue_set, struct semaphore *const sem);
+
+/**
+ * @brief 等待集合中的任一对象就绪, 没有就绪对象时当前任务进入阻塞
+ * @param queue_set 队列集合对象
+ * @return 就绪的对象指针(消息队列或信号量)
+ * @note 每次消息发送或信号量释放对应一个就绪事件, 返回后应对该对象执行一次非阻塞的接收或获取
+ */
+void *queueset_select(struct queueset *const queue_set);
+
+/**
+ * @brief 尝试等待集合中的任一对象就绪, 超时直接返回
+ * @param queue_set 队列集合对象
+ * @param timeout 超时时间
+ * @return 就绪的对象指针, 超时返回NULL
+ */
+void *queueset_try_select(struct queueset *const queue_set, const tick_t timeout);
+
+/**
+ * @brief 获取因缓冲区满而丢弃的就绪事件数
+ * @param queue_set 队列集合对象
+ * @return 丢弃的事件数
+ * @note 只有绕过 select 直接接收或获取成员时才会丢弃事件, 正常使用时为0
+ */
+size_t queueset_get_dropped(const struct queueset *const queue_set);
+
+/**
+ * @brief 通知集合成员已就绪
+ * @param queue_set 队列集合对象
+ * @param member 就绪的成员对象
+ * @note 内部接口, 需在屏蔽中断时调用
+ */
+void queueset_notify(struct queueset *const queue_set, void *const member);
+
+#endif /* _ZHIYEC_QUEUESET_H */
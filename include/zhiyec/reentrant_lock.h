@@ -14,7 +14,11 @@
 
 struct reentrantlock;
 
+#if (USE_QUEUE_SET)
+#define REENTRANTLOCK_BYTE 40
+#else
 #define REENTRANTLOCK_BYTE 36
+#endif /* USE_QUEUE_SET */
 
 /**
  * @brief 初始化可重入锁
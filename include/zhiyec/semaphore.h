@@ -13,7 +13,13 @@
 
 struct semaphore;
 
+#if (USE_QUEUE_SET)
+struct queueset;
+
+#define SEMAPHORE_BYTE 20
+#else
 #define SEMAPHORE_BYTE 16
+#endif /* USE_QUEUE_SET */
 
 /**
  * @brief 初始化为二值信号量
@@ -66,4 +72,32 @@ bool semaphore_acquire_from_isr(struct semaphore *const sem);
  */
 void semaphore_release_from_isr(struct semaphore *const sem);
 
+#if (USE_QUEUE_SET)
+/**
+ * @brief 获取信号量当前的计数值
+ * @param sem 信号量对象
+ * @return 计数值, 为负数时表示等待获得信号量的任务数
+ */
+int semaphore_get_value(const struct semaphore *const sem);
+
+/**
+ * @brief 获取信号量的最大计数值
+ * @param sem 信号量对象
+ * @note 供队列集合模块使用
+ */
+int semaphore_get_max_value(const struct semaphore *const sem);
+
+/**
+ * @brief 获取信号量所属的队列集合
+ * @note 供队列集合模块使用
+ */
+struct queueset *semaphore_get_queueset(const struct semaphore *const sem);
+
+/**
+ * @brief 设置信号量所属的队列集合
+ * @note 供队列集合模块使用
+ */
+void semaphore_set_queueset(struct semaphore *const sem, struct queueset *const queue_set);
+#endif /* USE_QUEUE_SET */
+
 #endif /* _ZHIYEC_SEMAPHORE_H */
@@ -44,8 +44,27 @@ struct task_attribute {
     enum task_sched_method sched_method;
     /* 任务销毁回调函数 */
     void (*destroy)(stack_t *);
+#if (USE_KERNEL_INTROSPECTION)
+    /* 任务名称(可为NULL) */
+    const char *name;
+#endif /* USE_KERNEL_INTROSPECTION */
 };
 
+#if (USE_KERNEL_INTROSPECTION)
+enum task_state {
+    /* 就绪(在任务列表中) */
+    TASKSTATE_READY = 0U,
+    /* 正在运行(仅出现在任务快照中) */
+    TASKSTATE_RUNNING,
+    /* 睡眠 */
+    TASKSTATE_SLEEPING,
+    /* 等待内核对象 */
+    TASKSTATE_BLOCKED,
+    /* 等待删除 */
+    TASKSTATE_DELETED,
+};
+#endif /* USE_KERNEL_INTROSPECTION */
+
 struct task_struct {
     /* 栈顶指针(必须是结构体的第一个成员) */
     volatile stack_t *top_of_stack;
@@ -57,6 +76,20 @@ struct task_struct {
     struct slist_head task_node;
     /* 恢复执行的时间 */
     tick_t resume_time;
+#if (USE_DYNAMIC_MEMORY_ALLOCATION)
+    /* 任务拥有的内存块(以链表节点开头), 删除任务时一并释放 */
+    struct stack_list owned_memory;
+#endif /* USE_DYNAMIC_MEMORY_ALLOCATION */
+#if (USE_KERNEL_INTROSPECTION)
+    /* 任务栈大小(单位: 字(word)) */
+    stack_t stack_size;
+    /* 任务状态 */
+    volatile enum task_state state;
+    /* 任务运行的Tick数 */
+    volatile tick_t run_ticks;
+    /* 所有任务的链表 */
+    struct slist_head registry_node;
+#endif /* USE_KERNEL_INTROSPECTION */
 };
 
 /**
@@ -152,6 +185,58 @@ static always_inline struct task_struct *task_get_from_node(const struct slist_h
  */
 #define task_yield() port_yield()
 
+#if (USE_KERNEL_INTROSPECTION)
+/* 任务栈填充值, 用于统计栈的最大用量 */
+#define TASK_STACK_FILL_PATTERN ((stack_t)0xA5A5A5A5U)
+
+/* 任务快照 */
+struct task_snapshot {
+    /* 任务标识(仅用于比较, 不可访问) */
+    const struct task_struct *task;
+    /* 任务名称(可为NULL) */
+    const char *name;
+    enum task_priority priority;
+    enum task_sched_method sched_method;
+    enum task_state state;
+    /* 恢复执行的时间(睡眠时有效) */
+    tick_t resume_time;
+    /* 任务运行的Tick数 */
+    tick_t run_ticks;
+    /* 任务栈大小(单位: 字(word)) */
+    size_t stack_size;
+    /* 从未使用过的栈大小(单位: 字(word)) */
+    size_t stack_unused;
+};
+
+/* 调度器快照 */
+struct task_sched_snapshot {
+    /* 当前Tick计数 */
+    tick_t ticks;
+    /* 任务数量 */
+    size_t task_count;
+    /* 就绪列表位图(第n位对应优先级n) */
+    uint32_t ready_bitmap;
+    /* 睡眠列表中的任务数量 */
+    size_t sleeping_count;
+};
+
+/**
+ * @brief 获取所有任务的快照
+ * @param snapshots 快照数组
+ * @param max_count 快照数组大小
+ * @return 写入的快照数量
+ * @note 逐个任务短暂屏蔽中断复制, 栈用量在屏蔽中断之外统计;
+ *       复制过程中有任务创建或删除时重新开始, 不可在中断中调用
+ */
+size_t task_get_snapshot(struct task_snapshot *const snapshots, const size_t max_count);
+
+/**
+ * @brief 获取调度器快照
+ * @param snapshot 调度器快照
+ */
+void task_get_sched_snapshot(struct task_sched_snapshot *const snapshot);
+#endif /* USE_KERNEL_INTROSPECTION */
+
 /**
  * @brief 查询是否需要切换任务
  * @note 同时更新Tick计数和任务状态
@@ -37,6 +37,10 @@ static always_inline void tasklist_append(const enum task_priority priority, str
     queue_list_push(kernel_task_list[priority], node);
 
     kernel_task_list_bitmap |= 1U << priority;
+
+#if (USE_KERNEL_INTROSPECTION)
+    task_get_from_node(node)->state = TASKSTATE_READY;
+#endif /* USE_KERNEL_INTROSPECTION */
 }
 
 /* 将列表的头节点移除并返回它 */
@@ -55,6 +59,11 @@ static always_inline struct slist_head *tasklist_remove_front(const enum task_pr
         kernel_task_list_bitmap &= ~(1U << priority);
     }
 
+#if (USE_KERNEL_INTROSPECTION)
+    /* 移出任务列表的任务默认为等待内核对象, 睡眠和删除时另行设置 */
+    task_get_from_node(front_node)->state = TASKSTATE_BLOCKED;
+#endif /* USE_KERNEL_INTROSPECTION */
+
     return front_node;
 }
 
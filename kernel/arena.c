@@ -0,0 +1,120 @@
+#include <config.h>
+#include <zhiyec/arena.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/list.h>
+#include <zhiyec/memory.h>
+#include <zhiyec/task.h>
+#include <zhiyec/types.h>
+
+#if (!USE_DYNAMIC_MEMORY_ALLOCATION)
+#error please set USE_DYNAMIC_MEMORY_ALLOCATION to 1 or remove this file from your project.
+#endif
+
+struct arena {
+    /* 所属任务的内存块链表节点(必须是结构体的第一个成员) */
+    struct slist_head node;
+    /* 所属任务, 为NULL时不属于任何任务 */
+    struct task_struct *owner;
+    /* 下一次分配的位置 */
+    byte *pos;
+    /* 可分配内存的结束位置 */
+    byte *end;
+};
+
+/* 任务删除时按内存块起始地址释放 */
+static_assert(offsetof(struct arena, node) == 0, "node must be the first member");
+
+/* 对象头大小(可分配内存相对对象地址的偏移) */
+#define ARENA_HEADER_SIZE ((sizeof(struct arena) + (BYTE_ALIGNMENT - 1)) & ~(size_t)(BYTE_ALIGNMENT - 1))
+
+#define arena_data(arena) ((byte *)(arena) + ARENA_HEADER_SIZE)
+
+/* 创建区域分配器 */
+static struct arena *arena_do_create(const size_t size, struct task_struct *const owner) {
+    struct arena *const arena = (struct arena *)memory_alloc(ARENA_HEADER_SIZE + size);
+
+    if (arena == NULL) {
+        return NULL;
+    }
+
+    arena->node.next = NULL;
+    arena->owner = owner;
+    arena->pos = arena_data(arena);
+    arena->end = arena_data(arena) + size;
+
+    return arena;
+}
+
+struct arena *arena_create(const size_t size) {
+    return arena_do_create(size, NULL);
+}
+
+struct arena *arena_create_task_owned(const size_t size) {
+    struct task_struct *const task = task_get_current();
+    assert(task != NULL);
+
+    struct arena *const arena = arena_do_create(size, task);
+
+    if (arena != NULL) {
+        atomic({
+            stack_list_push(task->owned_memory, &(arena->node));
+        });
+    }
+
+    return arena;
+}
+
+/* 分配内存 */
+void *arena_alloc(struct arena *const arena, const size_t size) {
+    assert(arena != NULL);
+
+    const size_t aligned_size = (size + (BYTE_ALIGNMENT - 1)) & ~(size_t)(BYTE_ALIGNMENT - 1);
+
+    /* 空间不足(同时防止大小溢出) */
+    if (aligned_size < size || aligned_size > (size_t)(arena->end - arena->pos)) {
+        return NULL;
+    }
+
+    void *const ptr = arena->pos;
+    arena->pos += aligned_size;
+
+    return ptr;
+}
+
+/* 重置区域分配器 */
+void arena_reset(struct arena *const arena) {
+    assert(arena != NULL);
+
+    arena->pos = arena_data(arena);
+}
+
+/* 销毁区域分配器 */
+void arena_destroy(struct arena *const arena) {
+    if (arena == NULL) {
+        return;
+    }
+
+    /* 从所属任务的内存块链表中移除 */
+    if (arena->owner != NULL) {
+        atomic({
+            struct slist_head **link = &stack_list_front(arena->owner->owned_memory);
+
+            while (*link != NULL && *link != &(arena->node)) {
+                link = &((*link)->next);
+            }
+
+            if (*link != NULL) {
+                *link = arena->node.next;
+            }
+        });
+    }
+
+    memory_free(arena);
+}
+
+size_t arena_get_free_size(const struct arena *const arena) {
+    assert(arena != NULL);
+
+    return (size_t)(arena->end - arena->pos);
+}
@@ -0,0 +1,286 @@
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/event_flags.h>
+#include <zhiyec/kernel.h>
+#include <zhiyec/list.h>
+#include <zhiyec/task_list.h>
+#if (USE_KERNEL_INTROSPECTION)
+#include <zhiyec/kobject.h>
+#endif
+
+struct eventflags {
+    /* 事件位 */
+    volatile uint32_t flags;
+    /* 等待者列表 */
+    struct queue_list waiters;
+};
+
+static_assert(EVENTFLAGS_BYTE == sizeof(struct eventflags), "size mismatch");
+
+/* 等待者(位于等待任务的栈上) */
+struct eventflags_waiter {
+    /* 等待者链表节点 */
+    struct slist_head node;
+    /* 阻塞等待的任务, 为NULL时表示带超时的轮询等待 */
+    struct task_struct *task;
+    /* 等待的事件位 */
+    uint32_t mask;
+    /* 等待选项 */
+    uint32_t options;
+    /* 满足条件时的事件位(清除前) */
+    uint32_t result;
+    /* 条件是否已满足 */
+    volatile bool is_satisfied;
+};
+
+/* 检查等待条件是否满足 */
+#define eventflags_condition_is_met(flags, mask, options) \
+    (((options) & EVENTFLAGS_WAIT_ALL) ? (((flags) & (mask)) == (mask)) : (((flags) & (mask)) != 0U))
+
+/* 初始化事件标志 */
+struct eventflags *eventflags_init(void *const event_flags_mem, const uint32_t init_flags) {
+    assert(event_flags_mem != NULL);
+
+    struct eventflags *event_flags = (struct eventflags *)event_flags_mem;
+
+    event_flags->flags = init_flags;
+    queue_list_init(event_flags->waiters);
+
+    return event_flags;
+}
+
+/* 将节点从等待者列表中移除, prev为节点的前驱 */
+static always_inline void eventflags_unlink(struct eventflags *const event_flags,
+                                            struct slist_head *const prev, struct slist_head *const node) {
+    prev->next = node->next;
+
+    if (node == queue_list_back(event_flags->waiters)) {
+        queue_list_back(event_flags->waiters) = prev;
+    }
+
+    node->next = NULL;
+}
+
+/* 置位事件, 并在一次遍历中唤醒条件满足的等待者; 需在屏蔽中断时调用, 返回置位后(清除前)的事件位 */
+static uint32_t eventflags_do_set(struct eventflags *const event_flags, const uint32_t flags) {
+    const uint32_t value = event_flags->flags | flags;
+    /* 等待者要求清除的事件位, 在遍历结束后统一清除 */
+    uint32_t clear_flags = 0U;
+
+    struct slist_head *prev = &(event_flags->waiters.head);
+
+    while (prev != queue_list_back(event_flags->waiters)) {
+        struct slist_head *const node = prev->next;
+        struct eventflags_waiter *const waiter = container_of(node, struct eventflags_waiter, node);
+
+        if (!eventflags_condition_is_met(value, waiter->mask, waiter->options)) {
+            prev = node;
+            continue;
+        }
+
+        eventflags_unlink(event_flags, prev, node);
+
+        if (waiter->options & EVENTFLAGS_CLEAR_ON_EXIT) {
+            clear_flags |= waiter->mask;
+        }
+
+        struct task_struct *const task = waiter->task;
+
+        waiter->result = value;
+        waiter->is_satisfied = true;
+
+        /* 唤醒阻塞的任务 */
+        if (task != NULL) {
+            tasklist_append(task_get_priority(task), &(task->task_node));
+        }
+    }
+
+    event_flags->flags = value & ~clear_flags;
+
+    return value;
+}
+
+/* 将等待者从列表中移除, 需在屏蔽中断时调用 */
+static void eventflags_remove_waiter(struct eventflags *const event_flags, struct eventflags_waiter *const waiter) {
+    struct slist_head *prev = &(event_flags->waiters.head);
+
+    while (prev != queue_list_back(event_flags->waiters)) {
+        if (prev->next == &(waiter->node)) {
+            eventflags_unlink(event_flags, prev, &(waiter->node));
+            return;
+        }
+        prev = prev->next;
+    }
+}
+
+/* 等待事件(可先置位事件) */
+static bool eventflags_do_wait(struct eventflags *const event_flags, const uint32_t set_flags,
+                               const uint32_t mask, const uint32_t options, uint32_t *const flags,
+                               const bool has_timeout, tick_t timeout) {
+    assert(event_flags != NULL);
+
+    struct eventflags_waiter waiter = {
+        .task = NULL,
+        .mask = mask,
+        .options = options,
+        .result = 0U,
+        .is_satisfied = false,
+    };
+
+    atomic_begin();
+
+    const uint32_t value = (set_flags != 0U) ? eventflags_do_set(event_flags, set_flags) : event_flags->flags;
+
+    if (eventflags_condition_is_met(value, mask, options)) {
+        /* 条件已满足, 直接返回 */
+        if (options & EVENTFLAGS_CLEAR_ON_EXIT) {
+            event_flags->flags &= ~mask;
+        }
+
+        waiter.result = value;
+        waiter.is_satisfied = true;
+
+    } else if (!has_timeout || timeout > 0) {
+        if (!has_timeout) {
+            /* 进入阻塞 */
+            struct slist_head *const front_node = tasklist_remove_front(task_get_priority(task_get_current()));
+
+            if (front_node) {
+                waiter.task = task_get_from_node(front_node);
+            }
+        }
+
+        queue_list_push(event_flags->waiters, &(waiter.node));
+    }
+
+    atomic_end();
+
+    tick_t current_tick = tick_get_current();
+
+    while (!waiter.is_satisfied) {
+        /* 超时处理 */
+        if (has_timeout) {
+            if (timeout == 0) {
+                break;
+            }
+
+            if (tick_after(tick_get_current(), current_tick + 1)) {
+                current_tick = tick_get_current();
+                --timeout;
+                continue;
+            }
+        }
+
+        task_yield();
+    }
+
+    /* 超时, 若期间条件仍未满足则移除等待者 */
+    if (!waiter.is_satisfied) {
+        atomic({
+            if (!waiter.is_satisfied) {
+                eventflags_remove_waiter(event_flags, &waiter);
+            }
+        });
+    }
+
+    if (flags != NULL) {
+        *flags = waiter.result;
+    }
+
+    return waiter.is_satisfied;
+}
+
+uint32_t eventflags_wait(struct eventflags *const event_flags, const uint32_t mask, const uint32_t options) {
+    uint32_t flags = 0U;
+    (void)eventflags_do_wait(event_flags, 0U, mask, options, &flags, false, 0);
+    return flags;
+}
+
+bool eventflags_try_wait(struct eventflags *const event_flags, const uint32_t mask, const uint32_t options,
+                         uint32_t *const flags, const tick_t timeout) {
+    return eventflags_do_wait(event_flags, 0U, mask, options, flags, true, timeout);
+}
+
+/* 置位事件 */
+uint32_t eventflags_set(struct eventflags *const event_flags, const uint32_t flags) {
+    assert(event_flags != NULL);
+
+    uint32_t value;
+
+    atomic({
+        (void)eventflags_do_set(event_flags, flags);
+        value = event_flags->flags;
+    });
+
+    return value;
+}
+
+uint32_t eventflags_set_from_isr(struct eventflags *const event_flags, const uint32_t flags) {
+    assert(event_flags != NULL);
+
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    (void)eventflags_do_set(event_flags, flags);
+    const uint32_t value = event_flags->flags;
+
+    irq_enable_from_isr(prev_basepri);
+
+    return value;
+}
+
+/* 清除事件 */
+uint32_t eventflags_clear(struct eventflags *const event_flags, const uint32_t flags) {
+    assert(event_flags != NULL);
+
+    uint32_t value;
+
+    atomic({
+        value = event_flags->flags;
+        event_flags->flags = value & ~flags;
+    });
+
+    return value;
+}
+
+uint32_t eventflags_get(const struct eventflags *const event_flags) {
+    assert(event_flags != NULL);
+
+    return event_flags->flags;
+}
+
+/* 同步点 */
+uint32_t eventflags_sync(struct eventflags *const event_flags, const uint32_t flags, const uint32_t wait_flags) {
+    uint32_t value = 0U;
+    (void)eventflags_do_wait(event_flags, flags, wait_flags,
+                             EVENTFLAGS_WAIT_ALL | EVENTFLAGS_CLEAR_ON_EXIT, &value, false, 0);
+    return value;
+}
+
+bool eventflags_try_sync(struct eventflags *const event_flags, const uint32_t flags, const uint32_t wait_flags,
+                         const tick_t timeout) {
+    return eventflags_do_wait(event_flags, flags, wait_flags,
+                              EVENTFLAGS_WAIT_ALL | EVENTFLAGS_CLEAR_ON_EXIT, NULL, true, timeout);
+}
+
+#if (USE_KERNEL_INTROSPECTION)
+/* 获取内核对象信息 */
+void eventflags_get_kobject_info(const void *object, struct kobject_info *info) {
+    const struct eventflags *const event_flags = (const struct eventflags *)object;
+
+    size_t waiting_count = 0U;
+
+    atomic({
+        info->value = event_flags->flags;
+
+        const struct slist_head *prev = &(event_flags->waiters.head);
+        while (prev != queue_list_back(event_flags->waiters)) {
+            prev = prev->next;
+            ++waiting_count;
+        }
+    });
+
+    info->type = "eventflags";
+    info->capacity = 0U;
+    info->waiting_count = waiting_count;
+}
+#endif /* USE_KERNEL_INTROSPECTION */
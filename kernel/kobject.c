@@ -0,0 +1,69 @@
+#include <config.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/kernel.h>
+#include <zhiyec/kobject.h>
+#include <zhiyec/list.h>
+
+#if (!USE_KERNEL_INTROSPECTION)
+#error please set USE_KERNEL_INTROSPECTION to 1 or remove this file from your project.
+#endif
+
+struct kobject {
+    /* 注册列表节点 */
+    struct slist_head node;
+    /* 对象名称 */
+    const char *name;
+    /* 内核对象 */
+    const void *object;
+    /* 获取对象信息的函数 */
+    void (*get_info)(const void *, struct kobject_info *);
+};
+
+static_assert(KOBJECT_BYTE == sizeof(struct kobject), "size mismatch");
+
+/* 已注册的对象列表, 只增加不删除 */
+static struct stack_list kobject_list;
+
+/* 注册内核对象 */
+void kobject_register(void *const kobject_mem, const char *const name, const void *const object,
+                      void (*const get_info)(const void *, struct kobject_info *)) {
+    assert(kobject_mem != NULL);
+    assert(object != NULL);
+    assert(get_info != NULL);
+
+    struct kobject *const kobject = (struct kobject *)kobject_mem;
+
+    kobject->name = name;
+    kobject->object = object;
+    kobject->get_info = get_info;
+
+    atomic({
+        stack_list_push(kobject_list, &(kobject->node));
+    });
+}
+
+/* 获取已注册对象的信息 */
+size_t kobject_get_snapshot(struct kobject_info *const infos, const size_t max_count) {
+    assert(infos != NULL);
+
+    struct slist_head *node;
+    size_t count = 0U;
+
+    atomic({
+        node = stack_list_front(kobject_list);
+    });
+
+    /* 节点只会添加到列表头部, 取得头节点后可以不加锁遍历 */
+    while (node != NULL && count < max_count) {
+        const struct kobject *const kobject = container_of(node, struct kobject, node);
+
+        kobject->get_info(kobject->object, &infos[count]);
+        infos[count].name = kobject->name;
+
+        ++count;
+        node = node->next;
+    }
+
+    return count;
+}
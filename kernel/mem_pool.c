@@ -0,0 +1,226 @@
+#include <asm/exclusive.h>
+#include <asm/irq.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/list.h>
+#include <zhiyec/mem_pool.h>
+#include <zhiyec/task.h>
+#if (USE_KERNEL_INTROSPECTION)
+#include <zhiyec/kobject.h>
+#endif
+
+struct mempool {
+    /* 空闲块链表头 */
+    struct slist_head *volatile free_list;
+    /* 内存块所在的内存 */
+    byte *mem;
+    /* 内存块大小 */
+    size_t block_size;
+    /* 内存块数量 */
+    size_t block_count;
+    /* 当前空闲的内存块数量 */
+    volatile size_t free_count;
+    /* 历史最少空闲的内存块数量 */
+    volatile size_t min_free_count;
+    /* 分配失败次数 */
+    volatile size_t failed_count;
+};
+
+static_assert(MEMPOOL_BYTE == sizeof(struct mempool), "size mismatch");
+
+/* 初始化内存池 */
+struct mempool *mempool_init(void *const mem_pool_mem, void *const mem, const size_t block_size, const size_t count) {
+    assert(mem_pool_mem != NULL);
+    assert(mem != NULL);
+    assert(((size_t)mem & (sizeof(void *) - 1U)) == 0U);
+
+    struct mempool *mem_pool = (struct mempool *)mem_pool_mem;
+
+    mem_pool->mem = (byte *)mem;
+    mem_pool->block_size = MEMPOOL_BLOCK_SIZE(block_size);
+    mem_pool->block_count = count;
+    mem_pool->free_count = count;
+    mem_pool->min_free_count = count;
+    mem_pool->failed_count = 0U;
+
+    /* 将所有内存块串成空闲链表 */
+    struct slist_head *next = NULL;
+    for (size_t i = count; i-- > 0;) {
+        struct slist_head *const node = (struct slist_head *)(mem_pool->mem + i * mem_pool->block_size);
+        node->next = next;
+        next = node;
+    }
+    mem_pool->free_list = next;
+
+    return mem_pool;
+}
+
+#if (ARCH_HAS_EXCLUSIVE_ACCESS)
+
+/* 无锁地取出空闲链表头 */
+static inline struct slist_head *mempool_pop(struct mempool *const mem_pool) {
+    struct slist_head *head;
+
+    do {
+        head = (struct slist_head *)exclusive_load((volatile uint32_t *)&(mem_pool->free_list));
+        if (head == NULL) {
+            exclusive_clear();
+            return NULL;
+        }
+    } while (!exclusive_store((volatile uint32_t *)&(mem_pool->free_list), (uint32_t)head->next));
+
+    return head;
+}
+
+/* 无锁地放回空闲链表头 */
+static inline void mempool_push(struct mempool *const mem_pool, struct slist_head *const node) {
+    do {
+        node->next = (struct slist_head *)exclusive_load((volatile uint32_t *)&(mem_pool->free_list));
+    } while (!exclusive_store((volatile uint32_t *)&(mem_pool->free_list), (uint32_t)node));
+}
+
+/* 无锁地修改计数, 返回修改后的值 */
+static inline size_t mempool_counter_add(volatile size_t *const counter, const size_t delta) {
+    uint32_t value;
+
+    do {
+        value = exclusive_load((volatile uint32_t *)counter) + (uint32_t)delta;
+    } while (!exclusive_store((volatile uint32_t *)counter, value));
+
+    return value;
+}
+
+#else
+
+/* 不支持独占访问的架构(Cortex-M0)以短暂屏蔽中断代替 */
+
+static inline struct slist_head *mempool_pop(struct mempool *const mem_pool) {
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    struct slist_head *const head = mem_pool->free_list;
+    if (head != NULL) {
+        mem_pool->free_list = head->next;
+    }
+
+    irq_enable_from_isr(prev_basepri);
+
+    return head;
+}
+
+static inline void mempool_push(struct mempool *const mem_pool, struct slist_head *const node) {
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    node->next = mem_pool->free_list;
+    mem_pool->free_list = node;
+
+    irq_enable_from_isr(prev_basepri);
+}
+
+static inline size_t mempool_counter_add(volatile size_t *const counter, const size_t delta) {
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    const size_t value = *counter + delta;
+    *counter = value;
+
+    irq_enable_from_isr(prev_basepri);
+
+    return value;
+}
+
+#endif /* ARCH_HAS_EXCLUSIVE_ACCESS */
+
+/* 记录一次成功的分配 */
+static inline void mempool_record_alloc(struct mempool *const mem_pool) {
+    const size_t free_count = mempool_counter_add(&(mem_pool->free_count), (size_t)-1);
+
+    /* 仅用于统计, 允许与并发更新产生偏差 */
+    if (free_count < mem_pool->min_free_count) {
+        mem_pool->min_free_count = free_count;
+    }
+}
+
+/* 分配内存块 */
+void *mempool_alloc(struct mempool *const mem_pool) {
+    assert(mem_pool != NULL);
+
+    struct slist_head *const block = mempool_pop(mem_pool);
+
+    if (block == NULL) {
+        (void)mempool_counter_add(&(mem_pool->failed_count), 1U);
+        return NULL;
+    }
+
+    mempool_record_alloc(mem_pool);
+
+    return block;
+}
+
+/* 尝试分配内存块, 超时后返回 */
+void *mempool_try_alloc(struct mempool *const mem_pool, tick_t timeout) {
+    assert(mem_pool != NULL);
+
+    tick_t current_tick = tick_get_current();
+
+    while (true) {
+        struct slist_head *const block = mempool_pop(mem_pool);
+
+        if (block != NULL) {
+            mempool_record_alloc(mem_pool);
+            return block;
+        }
+
+        /* 超时处理 */
+        if (timeout == 0) {
+            (void)mempool_counter_add(&(mem_pool->failed_count), 1U);
+            return NULL;
+        }
+
+        if (tick_after(tick_get_current(), current_tick + 1)) {
+            current_tick = tick_get_current();
+            --timeout;
+            continue;
+        }
+
+        task_yield();
+    }
+}
+
+/* 释放内存块 */
+void mempool_free(struct mempool *const mem_pool, void *const ptr) {
+    assert(mem_pool != NULL);
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    /* 内存块不属于该内存池 */
+    assert((byte *)ptr >= mem_pool->mem &&
+           (byte *)ptr < mem_pool->mem + mem_pool->block_size * mem_pool->block_count);
+
+    mempool_push(mem_pool, (struct slist_head *)ptr);
+    (void)mempool_counter_add(&(mem_pool->free_count), 1U);
+}
+
+/* 获取统计信息 */
+void mempool_get_stats(const struct mempool *const mem_pool, struct mempool_stats *const stats) {
+    assert(mem_pool != NULL);
+    assert(stats != NULL);
+
+    stats->block_size = mem_pool->block_size;
+    stats->block_count = mem_pool->block_count;
+    stats->free_count = mem_pool->free_count;
+    stats->min_free_count = mem_pool->min_free_count;
+    stats->failed_count = mem_pool->failed_count;
+}
+
+#if (USE_KERNEL_INTROSPECTION)
+/* 获取内核对象信息 */
+void mempool_get_kobject_info(const void *object, struct kobject_info *info) {
+    const struct mempool *const mem_pool = (const struct mempool *)object;
+
+    info->type = "mempool";
+    info->value = mem_pool->block_count - mem_pool->free_count;
+    info->capacity = mem_pool->block_count;
+    /* 内存池只支持轮询等待, 不记录等待的任务 */
+    info->waiting_count = 0U;
+}
+#endif /* USE_KERNEL_INTROSPECTION */
@@ -1,105 +1,592 @@
 #include <asm/port.h>
 #include <config.h>
+#include <stdint.h>
+#include <zhiyec/assert.h>
 #include <zhiyec/atomic.h>
+#include <zhiyec/compiler.h>
 #include <zhiyec/memory.h>
 #include <zhiyec/task.h>
+#include <zhiyec/tick.h>
 #include <zhiyec/types.h>
 
 #define MEMORYPOOL_SIZE (CONFIG_MEMORYPOOL_SIZE)
+#define MEMORY_REGION_MAX_NUM (CONFIG_MEMORY_REGION_MAX_NUM)
+#define CACHE_LINE_SIZE (CONFIG_CACHE_LINE_SIZE)
+
+static_assert((CACHE_LINE_SIZE & (CACHE_LINE_SIZE - 1)) == 0, "cache line size must be a power of 2");
 
 #if (!USE_DYNAMIC_MEMORY_ALLOCATION)
 #error please set USE_DYNAMIC_MEMORY_ALLOCATION to 1 or remove this file from your project.
 #endif
 
-struct memory_block_info {
-    struct memory_block_info *next_mem_block;
+/**
+ * 两级分离适配(TLSF)分配器
+ * 空闲块按大小映射到 一级(2的幂区间) x 二级(区间内等分) 的链表中, 两级均有位图,
+ * 分配和释放只需常数次位运算与链表操作, 执行时间与已分配块数量无关.
+ * 每个内存区域拥有独立的堆, 按区域属性选择分配的堆, 释放时按地址查找所在的堆.
+ */
+
+/* 二级链表数量的对数(每个2的幂区间等分为8份) */
+#define SL_INDEX_COUNT_LOG2 3
+#define SL_INDEX_COUNT (1U << SL_INDEX_COUNT_LOG2)
+
+/* 对齐位数的对数 */
+#define ALIGN_SIZE_LOG2 3
+static_assert((1U << ALIGN_SIZE_LOG2) == BYTE_ALIGNMENT, "alignment mismatch");
+
+/* 小于该大小的块全部位于一级索引0, 按对齐大小线性划分 */
+#define FL_INDEX_SHIFT (SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2)
+#define SMALL_BLOCK_SIZE (1U << FL_INDEX_SHIFT)
+
+/* 向上取2的幂的对数(最小为8, 最大为24), 用于常量表达式 */
+#define MEMORY_LOG2_CEIL(n)                   \
+    ((n) <= (1UL << 8)    ? 8                 \
+     : (n) <= (1UL << 9)  ? 9                 \
+     : (n) <= (1UL << 10) ? 10                \
+     : (n) <= (1UL << 11) ? 11                \
+     : (n) <= (1UL << 12) ? 12                \
+     : (n) <= (1UL << 13) ? 13                \
+     : (n) <= (1UL << 14) ? 14                \
+     : (n) <= (1UL << 15) ? 15                \
+     : (n) <= (1UL << 16) ? 16                \
+     : (n) <= (1UL << 17) ? 17                \
+     : (n) <= (1UL << 18) ? 18                \
+     : (n) <= (1UL << 19) ? 19                \
+     : (n) <= (1UL << 20) ? 20                \
+     : (n) <= (1UL << 21) ? 21                \
+     : (n) <= (1UL << 22) ? 22                \
+     : (n) <= (1UL << 23) ? 23                \
+                          : 24)
+
+static_assert(CONFIG_MEMORY_BLOCK_SIZE_MAX <= (1UL << 24), "block size max is too large");
+
+/* 一级索引的最大值, 由单次分配的最大内存大小决定 */
+#define FL_INDEX_MAX (MEMORY_LOG2_CEIL(CONFIG_MEMORY_BLOCK_SIZE_MAX))
+#define FL_INDEX_COUNT (FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+
+/* 可分配的最大块大小 */
+#define BLOCK_SIZE_MAX ((size_t)1U << FL_INDEX_MAX)
+
+struct memory_block {
+    /* 物理上的前一个块 */
+    struct memory_block *prev_phys_block;
+    /* 块大小(不含块头), 最低位为空闲标志 */
     size_t size;
+
+    /* 以下成员仅在空闲块中有效, 与已分配块的用户数据重叠 */
+    struct memory_block *next_free;
+    struct memory_block *prev_free;
+};
+
+/* 块头大小(用户数据相对块地址的偏移) */
+#define BLOCK_HEADER_SIZE (offsetof(struct memory_block, next_free))
+static_assert((BLOCK_HEADER_SIZE & (BYTE_ALIGNMENT - 1)) == 0, "header must keep alignment");
+
+/* 最小块大小(需容纳空闲链表指针) */
+#define BLOCK_SIZE_MIN (sizeof(struct memory_block) - BLOCK_HEADER_SIZE)
+
+/* 空闲标志 */
+#define BLOCK_FREE_BIT ((size_t)1U)
+
+struct memory_heap {
+    /* 一级位图 */
+    uint32_t fl_bitmap;
+    /* 二级位图 */
+    uint32_t sl_bitmap[FL_INDEX_COUNT];
+    /* 空闲块链表 */
+    struct memory_block *blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+    /* 空闲内存大小 */
+    size_t free_size;
+    /* 空闲块数量 */
+    size_t free_block_count;
+};
+
+struct memory_region {
+    /* 区域的堆 */
+    struct memory_heap heap;
+    /* 区域的地址范围 */
+    byte *start;
+    byte *end;
+    /* 区域属性 */
+    uint32_t flags;
+};
+
+/* 所有内存区域汇总的统计计数 */
+struct memory_counters {
+    size_t min_ever_free_size;
+    size_t alloc_count;
+    size_t free_count;
+    size_t failed_alloc_count;
 };
 
 static byte memory_pool[MEMORYPOOL_SIZE];
-static byte *memory_pool_end = NULL;
-static size_t memory_pool_size = MEMORYPOOL_SIZE;
+static struct memory_region memory_regions[MEMORY_REGION_MAX_NUM];
+static size_t memory_region_count = 0U;
+static struct memory_counters memory_counters;
+static bool memory_heap_is_init = false;
+
+#if (USE_MEMORY_TRACE)
+
+#define MEMORY_TRACE_DEPTH (CONFIG_MEMORY_TRACE_DEPTH)
+static_assert((MEMORY_TRACE_DEPTH & (MEMORY_TRACE_DEPTH - 1)) == 0, "trace depth must be a power of 2");
+
+/* 跟踪记录环形缓冲区, 写满后覆盖最旧的记录 */
+static struct memory_trace_record memory_trace_records[MEMORY_TRACE_DEPTH];
+/* 已写入的记录总数 */
+static size_t memory_trace_count = 0U;
+
+/* 写入一条跟踪记录, 需在屏蔽中断时调用 */
+static inline void memory_trace_push(void *const caller, void *const ptr, const size_t size) {
+    struct memory_trace_record *const record =
+        &memory_trace_records[memory_trace_count & (MEMORY_TRACE_DEPTH - 1)];
+
+    record->timestamp = tick_get_current();
+    record->caller = caller;
+    record->ptr = ptr;
+    record->size = size;
+
+    ++memory_trace_count;
+}
+
+#else
 
-static struct memory_block_info *memory_block_head = NULL;
+#define memory_trace_push(caller, ptr, size) ((void)(caller))
 
-/* 内存块信息结构体大小(已对齐) */
-const static size_t MEMORY_BLOCK_STRUCT_SIZE = (sizeof(struct memory_block_info) + (BYTE_ALIGNMENT - 1)) & ~(BYTE_ALIGNMENT - 1);
+#endif /* USE_MEMORY_TRACE */
+
+/* 最高置位的位置 */
+#define memory_fls(x) ((unsigned int)(31U - count_leading_zeros(x)))
+/* 最低置位的位置 */
+#define memory_ffs(x) memory_fls((x) & (~(x) + 1U))
+
+/* 块状态 */
+#define block_get_size(block) ((block)->size & ~BLOCK_FREE_BIT)
+#define block_is_free(block) ((block)->size & BLOCK_FREE_BIT)
+#define block_to_ptr(block) ((void *)((byte *)(block) + BLOCK_HEADER_SIZE))
+#define block_from_ptr(ptr) ((struct memory_block *)((byte *)(ptr) - BLOCK_HEADER_SIZE))
+#define block_next(block) ((struct memory_block *)((byte *)(block) + BLOCK_HEADER_SIZE + block_get_size(block)))
+
+/* 计算块大小所在的链表 */
+static inline void memory_mapping_insert(const size_t size, unsigned int *const fl, unsigned int *const sl) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fl = 0U;
+        *sl = (unsigned int)size >> ALIGN_SIZE_LOG2;
+    } else {
+        const unsigned int t = memory_fls((uint32_t)size);
+        *sl = (unsigned int)(size >> (t - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT;
+        *fl = t - (FL_INDEX_SHIFT - 1U);
+    }
+}
+
+/* 计算分配时查找的起始链表(向上取整, 保证链表中任一块都足够大) */
+static inline void memory_mapping_search(size_t size, unsigned int *const fl, unsigned int *const sl) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1U << (memory_fls((uint32_t)size) - SL_INDEX_COUNT_LOG2)) - 1U;
+    }
+    memory_mapping_insert(size, fl, sl);
+}
+
+/* 查找不小于(fl, sl)的第一个非空链表 */
+static inline struct memory_block *memory_search_suitable_block(struct memory_heap *const heap,
+                                                                unsigned int *const fl, unsigned int *const sl) {
+    uint32_t sl_map = heap->sl_bitmap[*fl] & (~(uint32_t)0U << *sl);
+
+    if (sl_map == 0U) {
+        /* 当前一级区间没有合适的块, 查找更大的一级区间 */
+        const uint32_t fl_map = heap->fl_bitmap & (~(uint32_t)0U << (*fl + 1U));
+        if (fl_map == 0U) {
+            return NULL;
+        }
+
+        *fl = memory_ffs(fl_map);
+        sl_map = heap->sl_bitmap[*fl];
+    }
+
+    *sl = memory_ffs(sl_map);
+
+    return heap->blocks[*fl][*sl];
+}
+
+/* 将空闲块从链表中移除 */
+static inline void memory_remove_free_block(struct memory_heap *const heap, struct memory_block *const block,
+                                            const unsigned int fl, const unsigned int sl) {
+    struct memory_block *const prev = block->prev_free;
+    struct memory_block *const next = block->next_free;
+
+    if (next != NULL) {
+        next->prev_free = prev;
+    }
+    if (prev != NULL) {
+        prev->next_free = next;
+    }
+
+    /* 块为链表头 */
+    if (heap->blocks[fl][sl] == block) {
+        heap->blocks[fl][sl] = next;
+
+        if (next == NULL) {
+            heap->sl_bitmap[fl] &= ~(1U << sl);
+
+            if (heap->sl_bitmap[fl] == 0U) {
+                heap->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+
+    heap->free_size -= block_get_size(block);
+    --heap->free_block_count;
+}
+
+/* 将空闲块插入链表头部 */
+static inline void memory_insert_free_block(struct memory_heap *const heap, struct memory_block *const block) {
+    unsigned int fl;
+    unsigned int sl;
+    memory_mapping_insert(block_get_size(block), &fl, &sl);
+
+    struct memory_block *const current = heap->blocks[fl][sl];
+
+    block->next_free = current;
+    block->prev_free = NULL;
+    if (current != NULL) {
+        current->prev_free = block;
+    }
+
+    heap->blocks[fl][sl] = block;
+    heap->fl_bitmap |= 1U << fl;
+    heap->sl_bitmap[fl] |= 1U << sl;
+
+    heap->free_size += block_get_size(block);
+    ++heap->free_block_count;
+}
+
+/* 将任意空闲块从所在链表中移除 */
+static inline void memory_remove_block(struct memory_heap *const heap, struct memory_block *const block) {
+    unsigned int fl;
+    unsigned int sl;
+    memory_mapping_insert(block_get_size(block), &fl, &sl);
+    memory_remove_free_block(heap, block, fl, sl);
+}
+
+/* 若块剩余空间足够, 将剩余部分分割为新的空闲块 */
+static inline void memory_split_block(struct memory_heap *const heap, struct memory_block *const block,
+                                      const size_t size) {
+    const size_t block_size = block_get_size(block);
+
+    if (block_size < size + BLOCK_HEADER_SIZE + BLOCK_SIZE_MIN) {
+        return;
+    }
+
+    struct memory_block *const remaining = (struct memory_block *)((byte *)block_to_ptr(block) + size);
+    remaining->size = (block_size - size - BLOCK_HEADER_SIZE) | BLOCK_FREE_BIT;
+    remaining->prev_phys_block = block;
+    block_next(remaining)->prev_phys_block = remaining;
+
+    block->size = size | (block->size & BLOCK_FREE_BIT);
+
+    memory_insert_free_block(heap, remaining);
+}
+
+/* 初始化空堆 */
+static void memory_heap_init(struct memory_heap *const heap) {
+    heap->fl_bitmap = 0U;
+    for (size_t i = 0; i < FL_INDEX_COUNT; ++i) {
+        heap->sl_bitmap[i] = 0U;
+        for (size_t j = 0; j < SL_INDEX_COUNT; ++j) {
+            heap->blocks[i][j] = NULL;
+        }
+    }
+    heap->free_size = 0U;
+    heap->free_block_count = 0U;
+}
+
+/* 将内存区域加入堆, 超过最大块大小的区域分为多段, 每段末尾有各自的哨兵块 */
+static void memory_heap_add_pool(struct memory_heap *const heap, void *const mem, size_t size) {
+    size_t addr = (size_t)mem;
+
+    /* 内存对齐 */
+    if (addr & (BYTE_ALIGNMENT - 1)) {
+        const size_t aligned_addr = (addr + (BYTE_ALIGNMENT - 1)) & ~(BYTE_ALIGNMENT - 1);
+        if (size < aligned_addr - addr) {
+            return;
+        }
+        size -= aligned_addr - addr;
+        addr = aligned_addr;
+    }
+    size &= ~(size_t)(BYTE_ALIGNMENT - 1);
+
+    /* 需容纳一个块头和末尾的哨兵块头 */
+    while (size >= 2U * BLOCK_HEADER_SIZE + BLOCK_SIZE_MIN) {
+        size_t block_size = size - 2U * BLOCK_HEADER_SIZE;
+        if (block_size >= BLOCK_SIZE_MAX) {
+            block_size = BLOCK_SIZE_MAX - BYTE_ALIGNMENT;
+        }
+
+        struct memory_block *const block = (struct memory_block *)addr;
+        block->prev_phys_block = NULL;
+        block->size = block_size | BLOCK_FREE_BIT;
+
+        /* 哨兵块: 大小为0且已分配, 合并时不会越界 */
+        struct memory_block *const sentinel = block_next(block);
+        sentinel->prev_phys_block = block;
+        sentinel->size = 0U;
+
+        memory_insert_free_block(heap, block);
+
+        addr += block_size + 2U * BLOCK_HEADER_SIZE;
+        size -= block_size + 2U * BLOCK_HEADER_SIZE;
+    }
+}
+
+/* 添加内存区域, 需在屏蔽中断时调用 */
+static bool memory_region_add(void *const mem, const size_t size, const uint32_t flags) {
+    if (memory_region_count >= MEMORY_REGION_MAX_NUM) {
+        return false;
+    }
+
+    struct memory_region *const region = &memory_regions[memory_region_count];
+
+    memory_heap_init(&(region->heap));
+    memory_heap_add_pool(&(region->heap), mem, size);
+
+    /* 区域过小 */
+    if (region->heap.free_size == 0U) {
+        return false;
+    }
+
+    region->start = (byte *)mem;
+    region->end = (byte *)mem + size;
+    region->flags = flags;
+
+    ++memory_region_count;
+
+    return true;
+}
 
 /* 内存池初始化 */
 static inline void memory_pool_init() {
-    size_t memory_pool_addr = (size_t)memory_pool;
+    memory_region_count = 0U;
+    (void)memory_region_add(memory_pool, MEMORYPOOL_SIZE, CONFIG_MEMORYPOOL_REGION_FLAGS);
 
-    /* 内存对齐 */
-    if (memory_pool_addr & (BYTE_ALIGNMENT - 1)) {
-        memory_pool_addr = (memory_pool_addr + (BYTE_ALIGNMENT - 1)) & ~(BYTE_ALIGNMENT - 1);
-        memory_pool_size -= memory_pool_addr - (size_t)memory_pool;
+    memory_counters.min_ever_free_size = memory_regions[0].heap.free_size;
+    memory_counters.alloc_count = 0U;
+    memory_counters.free_count = 0U;
+    memory_counters.failed_alloc_count = 0U;
+
+    memory_heap_is_init = true;
+}
+
+/* 所有区域的空闲内存大小, 需在屏蔽中断时调用 */
+static size_t memory_total_free_size() {
+    size_t free_size = 0U;
+
+    for (size_t i = 0; i < memory_region_count; ++i) {
+        free_size += memory_regions[i].heap.free_size;
+    }
+
+    return free_size;
+}
+
+/* 按地址查找所在的区域 */
+static struct memory_region *memory_find_region(const void *const ptr) {
+    for (size_t i = 0; i < memory_region_count; ++i) {
+        if ((const byte *)ptr >= memory_regions[i].start && (const byte *)ptr < memory_regions[i].end) {
+            return &memory_regions[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* 将块的起始位置对齐, 前部的间隙分割为空闲块; 返回对齐后的块 */
+static inline struct memory_block *memory_align_block(struct memory_heap *const heap,
+                                                      struct memory_block *const block, const size_t align) {
+    const size_t ptr = (size_t)block_to_ptr(block);
+    size_t aligned_ptr = (ptr + (align - 1)) & ~(align - 1);
+
+    if (aligned_ptr == ptr) {
+        return block;
+    }
+
+    /* 间隙不足以构成一个空闲块时, 对齐到下一个边界 */
+    if (aligned_ptr - ptr < sizeof(struct memory_block)) {
+        aligned_ptr = (ptr + sizeof(struct memory_block) + (align - 1)) & ~(align - 1);
     }
 
-    struct memory_block_info *const mem_block_info = (struct memory_block_info *)memory_pool_addr;
-    mem_block_info->next_mem_block = NULL;
-    mem_block_info->size = MEMORY_BLOCK_STRUCT_SIZE;
-    memory_block_head = mem_block_info;
+    const size_t gap = aligned_ptr - ptr;
+
+    struct memory_block *const aligned_block = block_from_ptr(aligned_ptr);
+    aligned_block->prev_phys_block = block;
+    aligned_block->size = (block_get_size(block) - gap) | BLOCK_FREE_BIT;
+    block_next(aligned_block)->prev_phys_block = aligned_block;
 
-    /* 获取内存池末尾地址 */
-    memory_pool_addr += memory_pool_size;
-    memory_pool_addr = (memory_pool_addr - MEMORY_BLOCK_STRUCT_SIZE) & ~(BYTE_ALIGNMENT - 1);
-    memory_pool_end = (byte *)memory_pool_addr;
+    /* 原块的前一个物理块必然已分配, 间隙无需合并 */
+    block->size = (gap - BLOCK_HEADER_SIZE) | BLOCK_FREE_BIT;
+    memory_insert_free_block(heap, block);
+
+    return aligned_block;
 }
 
-/* 使用首次适应算法分配内存 */
-void *memory_alloc(size_t size) {
-    if (memory_block_head == NULL) {
-        atomic({
-            memory_pool_init();
-        });
+/* 从堆中分配内存 */
+static void *memory_heap_alloc(struct memory_heap *const heap, size_t size, const size_t align) {
+    /* 对齐并保证能容纳空闲链表指针 */
+    size = (size + (BYTE_ALIGNMENT - 1)) & ~(size_t)(BYTE_ALIGNMENT - 1);
+    if (size < BLOCK_SIZE_MIN) {
+        size = BLOCK_SIZE_MIN;
     }
 
-    if (size == 0) {
+    /* 更大的对齐需额外预留对齐间隙 */
+    const size_t search_size = (align > BYTE_ALIGNMENT) ? size + align + sizeof(struct memory_block) : size;
+
+    if (search_size >= BLOCK_SIZE_MAX) {
         return NULL;
     }
 
-    size += MEMORY_BLOCK_STRUCT_SIZE;
+    unsigned int fl;
+    unsigned int sl;
+    memory_mapping_search(search_size, &fl, &sl);
 
-    if (size & (BYTE_ALIGNMENT - 1)) {
-        size += BYTE_ALIGNMENT - (size & (BYTE_ALIGNMENT - 1));
+    if (fl >= FL_INDEX_COUNT) {
+        return NULL;
     }
 
-    if (memory_pool_size < size) {
+    struct memory_block *block = memory_search_suitable_block(heap, &fl, &sl);
+    if (block == NULL) {
         return NULL;
     }
 
-    atomic_begin();
+    memory_remove_free_block(heap, block, fl, sl);
+
+    if (align > BYTE_ALIGNMENT) {
+        block = memory_align_block(heap, block, align);
+    }
+
+    memory_split_block(heap, block, size);
+
+    block->size &= ~BLOCK_FREE_BIT;
+
+    return block_to_ptr(block);
+}
+
+/* 释放内存到堆中, 立即与相邻的空闲块合并 */
+static void memory_heap_free(struct memory_heap *const heap, void *const ptr) {
+    struct memory_block *block = block_from_ptr(ptr);
+
+    block->size |= BLOCK_FREE_BIT;
+
+    /* 与前一个空闲块合并 */
+    struct memory_block *const prev = block->prev_phys_block;
+    if (prev != NULL && block_is_free(prev)) {
+        memory_remove_block(heap, prev);
+        prev->size += BLOCK_HEADER_SIZE + block_get_size(block);
+        block = prev;
+        block_next(block)->prev_phys_block = block;
+    }
+
+    /* 与后一个空闲块合并 */
+    struct memory_block *const next = block_next(block);
+    if (block_is_free(next)) {
+        memory_remove_block(heap, next);
+        block->size += BLOCK_HEADER_SIZE + block_get_size(next);
+        block_next(block)->prev_phys_block = block;
+    }
+
+    memory_insert_free_block(heap, block);
+}
+
+/* 在满足属性的区域中依次尝试分配, 需在屏蔽中断时调用 */
+static void *memory_regions_alloc(const uint32_t region_flags, const size_t size, const size_t align) {
+    for (size_t i = 0; i < memory_region_count; ++i) {
+        struct memory_region *const region = &memory_regions[i];
 
-    struct memory_block_info *current_mem_block = memory_block_head;
+        if ((region->flags & region_flags) != region_flags) {
+            continue;
+        }
+
+        size_t region_size = size;
+        size_t region_align = align;
+
+        /* 独占缓存行: 起始地址与大小均按缓存行对齐 */
+        if (region->flags & MEMORY_REGION_CACHE_ALIGNED) {
+            region_size = (size + (CACHE_LINE_SIZE - 1)) & ~(size_t)(CACHE_LINE_SIZE - 1);
+            if (region_align < CACHE_LINE_SIZE) {
+                region_align = CACHE_LINE_SIZE;
+            }
+        }
 
-    while (current_mem_block->next_mem_block != NULL) {
-        const byte *const next = (byte *)(current_mem_block->next_mem_block);
-        const byte *const current = (byte *)current_mem_block + current_mem_block->size;
-        if (next - current >= size) {
-            break;
+        void *const ptr = memory_heap_alloc(&(region->heap), region_size, region_align);
+        if (ptr != NULL) {
+            return ptr;
         }
-        current_mem_block = current_mem_block->next_mem_block;
     }
 
-    byte *const allocated_mem_head = (byte *)current_mem_block + current_mem_block->size;
+    return NULL;
+}
 
-    /* 找不到可用的内存碎片空间且末尾空间不足 */
-    if ((current_mem_block->next_mem_block == NULL) &&
-        (allocated_mem_head + size > memory_pool_end)) {
-        atomic_end();
+/* 分配内存 */
+static void *memory_do_alloc(const uint32_t region_flags, const size_t size, const size_t align,
+                             void *const caller) {
+    if (size == 0) {
         return NULL;
     }
 
-    struct memory_block_info *const mem_block_info = (struct memory_block_info *)allocated_mem_head;
+    void *ptr = NULL;
 
-    mem_block_info->next_mem_block = current_mem_block->next_mem_block;
-    mem_block_info->size = size;
-    current_mem_block->next_mem_block = mem_block_info;
-    memory_pool_size -= size;
+    atomic({
+        if (!memory_heap_is_init) {
+            memory_pool_init();
+        }
+
+        ptr = memory_regions_alloc(region_flags, size, align);
 
-    atomic_end();
+        if (ptr != NULL) {
+            const size_t free_size = memory_total_free_size();
 
-    return (void *)(allocated_mem_head + MEMORY_BLOCK_STRUCT_SIZE);
+            ++memory_counters.alloc_count;
+            if (free_size < memory_counters.min_ever_free_size) {
+                memory_counters.min_ever_free_size = free_size;
+            }
+        } else {
+            ++memory_counters.failed_alloc_count;
+        }
+
+        memory_trace_push(caller, ptr, size);
+    });
+
+    return ptr;
+}
+
+void *memory_alloc(size_t size) {
+    return memory_do_alloc(0U, size, 0U, return_address());
+}
+
+void *memory_alloc_in(const uint32_t region_flags, const size_t size, const size_t align) {
+    /* 对齐大小必须是2的幂 */
+    assert((align & (align - 1)) == 0U);
+
+    return memory_do_alloc(region_flags, size, align, return_address());
+}
+
+/* 添加内存区域 */
+bool memory_add_region(void *const mem, const size_t size, const uint32_t region_flags) {
+    if (mem == NULL) {
+        return false;
+    }
+
+    bool is_added = false;
+
+    atomic({
+        if (!memory_heap_is_init) {
+            memory_pool_init();
+        }
+
+        is_added = memory_region_add(mem, size, region_flags);
+
+        if (is_added) {
+            memory_counters.min_ever_free_size += memory_regions[memory_region_count - 1].heap.free_size;
+        }
+    });
+
+    return is_added;
 }
 
 /* 释放内存 */
@@ -108,19 +595,119 @@ void memory_free(void *const ptr) {
         return;
     }
 
-    const struct memory_block_info *const mem_block_info = (struct memory_block_info *)((byte *)ptr - MEMORY_BLOCK_STRUCT_SIZE);
+    void *const caller = return_address();
 
     atomic({
-        struct memory_block_info *prev_mem_block = memory_block_head;
-        while (prev_mem_block->next_mem_block != mem_block_info) {
-            prev_mem_block = prev_mem_block->next_mem_block;
-        }
+        struct memory_region *const region = memory_find_region(ptr);
+
+        /* 内存不属于任何区域 */
+        assert(region != NULL);
 
-        prev_mem_block->next_mem_block = mem_block_info->next_mem_block;
-        memory_pool_size += mem_block_info->size;
+        if (region != NULL) {
+            memory_heap_free(&(region->heap), ptr);
+            ++memory_counters.free_count;
+
+            memory_trace_push(caller, ptr, 0U);
+        }
     });
 }
 
 size_t memory_get_free_size() {
-    return memory_pool_size;
+    if (!memory_heap_is_init) {
+        return MEMORYPOOL_SIZE;
+    }
+
+    size_t free_size;
+
+    atomic({
+        free_size = memory_total_free_size();
+    });
+
+    return free_size;
+}
+
+/* 查找最大的空闲块, 需在屏蔽中断时调用 */
+static size_t memory_heap_largest_free_block(const struct memory_heap *const heap) {
+    if (heap->fl_bitmap == 0U) {
+        return 0U;
+    }
+
+    /* 最大的块必然位于最高的非空链表中, 只需遍历该链表 */
+    const unsigned int fl = memory_fls(heap->fl_bitmap);
+    const unsigned int sl = memory_fls(heap->sl_bitmap[fl]);
+
+    size_t largest = 0U;
+    for (const struct memory_block *block = heap->blocks[fl][sl]; block != NULL; block = block->next_free) {
+        if (block_get_size(block) > largest) {
+            largest = block_get_size(block);
+        }
+    }
+
+    return largest;
+}
+
+/* 获取堆统计信息 */
+void memory_get_stats(struct memory_stats *const stats) {
+    if (stats == NULL) {
+        return;
+    }
+
+    atomic({
+        if (!memory_heap_is_init) {
+            memory_pool_init();
+        }
+
+        stats->free_size = 0U;
+        stats->largest_free_block = 0U;
+        stats->free_block_count = 0U;
+
+        for (size_t i = 0; i < memory_region_count; ++i) {
+            const struct memory_heap *const heap = &(memory_regions[i].heap);
+            const size_t largest_free_block = memory_heap_largest_free_block(heap);
+
+            stats->free_size += heap->free_size;
+            stats->free_block_count += heap->free_block_count;
+            if (largest_free_block > stats->largest_free_block) {
+                stats->largest_free_block = largest_free_block;
+            }
+        }
+
+        stats->min_ever_free_size = memory_counters.min_ever_free_size;
+        stats->alloc_count = memory_counters.alloc_count;
+        stats->free_count = memory_counters.free_count;
+        stats->failed_alloc_count = memory_counters.failed_alloc_count;
+    });
+}
+
+/* 复制内存分配跟踪记录 */
+size_t memory_trace_copy(struct memory_trace_record *const records, const size_t max_count) {
+#if (USE_MEMORY_TRACE)
+    if (records == NULL) {
+        return 0U;
+    }
+
+    size_t count = 0U;
+
+    atomic({
+        count = memory_trace_count;
+        if (count > MEMORY_TRACE_DEPTH) {
+            count = MEMORY_TRACE_DEPTH;
+        }
+        if (count > max_count) {
+            count = max_count;
+        }
+
+        /* 复制最近的count条记录 */
+        const size_t first = memory_trace_count - count;
+        for (size_t i = 0; i < count; ++i) {
+            records[i] = memory_trace_records[(first + i) & (MEMORY_TRACE_DEPTH - 1)];
+        }
+    });
+
+    return count;
+#else
+    (void)records;
+    (void)max_count;
+    return 0U;
+#endif /* USE_MEMORY_TRACE */
 }
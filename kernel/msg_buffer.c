@@ -0,0 +1,309 @@
+#include <string.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/list.h>
+#include <zhiyec/msg_buffer.h>
+#include <zhiyec/task_list.h>
+
+struct msgbuffer {
+    /* 字节缓冲区 */
+    byte *buffer;
+    /* 缓冲区大小 */
+    size_t buffer_size;
+    /* 触发等级 */
+    size_t trigger_level;
+    /* 等待发送消息的任务 */
+    struct stack_list tasks_waiting_to_send;
+    /* 等待接收消息的任务 */
+    struct stack_list tasks_waiting_to_receive;
+
+    /* 读位置 */
+    size_t read_pos;
+    /* 写位置 */
+    size_t write_pos;
+    /* 已使用的字节数(含长度前缀) */
+    volatile size_t used_size;
+    /* 当前消息数量 */
+    volatile size_t msg_count;
+};
+
+static_assert(MSGBUFFER_BYTE == sizeof(struct msgbuffer), "size mismatch");
+
+/* 初始化消息缓冲区 */
+struct msgbuffer *msgbuffer_init(void *const msg_buffer_mem,
+                                 void *const buffer, const size_t buffer_size, const size_t trigger_level) {
+    assert(msg_buffer_mem != NULL);
+    assert(buffer != NULL);
+
+    struct msgbuffer *msg_buffer = (struct msgbuffer *)msg_buffer_mem;
+
+    msg_buffer->buffer = (byte *)buffer;
+    msg_buffer->buffer_size = buffer_size;
+    msg_buffer->trigger_level = trigger_level;
+    if (msg_buffer->trigger_level == 0U) {
+        msg_buffer->trigger_level = 1U;
+    } else if (msg_buffer->trigger_level > buffer_size) {
+        msg_buffer->trigger_level = buffer_size;
+    }
+    stack_list_init(msg_buffer->tasks_waiting_to_send);
+    stack_list_init(msg_buffer->tasks_waiting_to_receive);
+    msg_buffer->read_pos = 0U;
+    msg_buffer->write_pos = 0U;
+    msg_buffer->used_size = 0U;
+    msg_buffer->msg_count = 0U;
+
+    return msg_buffer;
+}
+
+/* 获取空闲空间大小 */
+#define msgbuffer_free_size(msg_buffer) ((msg_buffer)->buffer_size - (msg_buffer)->used_size)
+
+/* 唤醒等待列表中的所有任务 */
+#define msgbuffer_wake_all(waiting_list)                                   \
+    do {                                                                   \
+        while (!stack_list_is_empty(waiting_list)) {                       \
+            struct slist_head *const node = stack_list_front(waiting_list); \
+            stack_list_pop(waiting_list);                                  \
+                                                                           \
+            tasklist_append(task_get_priority(task_get_from_node(node)), node); \
+        }                                                                  \
+    } while (0)
+
+/* 将当前任务加入等待列表 */
+#define msgbuffer_block_current_task(waiting_list)                                                         \
+    do {                                                                                                   \
+        struct slist_head *const front_node = tasklist_remove_front(task_get_priority(task_get_current())); \
+                                                                                                           \
+        if (front_node) {                                                                                  \
+            stack_list_push(waiting_list, front_node);                                                     \
+        }                                                                                                  \
+    } while (0)
+
+/* 写入环形缓冲区, 返回新的写位置 */
+static inline size_t msgbuffer_copy_in(struct msgbuffer *const msg_buffer, size_t pos,
+                                       const byte *const src, const size_t len) {
+    const size_t first_len = (len < msg_buffer->buffer_size - pos) ? len : (msg_buffer->buffer_size - pos);
+
+    memcpy(msg_buffer->buffer + pos, src, first_len);
+    memcpy(msg_buffer->buffer, src + first_len, len - first_len);
+
+    pos += len;
+    if (pos >= msg_buffer->buffer_size) {
+        pos -= msg_buffer->buffer_size;
+    }
+
+    return pos;
+}
+
+/* 读出环形缓冲区, 返回新的读位置 */
+static inline size_t msgbuffer_copy_out(const struct msgbuffer *const msg_buffer, size_t pos,
+                                        byte *const dst, const size_t len) {
+    const size_t first_len = (len < msg_buffer->buffer_size - pos) ? len : (msg_buffer->buffer_size - pos);
+
+    memcpy(dst, msg_buffer->buffer + pos, first_len);
+    memcpy(dst + first_len, msg_buffer->buffer, len - first_len);
+
+    pos += len;
+    if (pos >= msg_buffer->buffer_size) {
+        pos -= msg_buffer->buffer_size;
+    }
+
+    return pos;
+}
+
+/* 读取下一条消息的长度前缀 */
+static inline size_t msgbuffer_peek_length(const struct msgbuffer *const msg_buffer) {
+    uint16_t len;
+    (void)msgbuffer_copy_out(msg_buffer, msg_buffer->read_pos, (byte *)&len, MSGBUFFER_LENGTH_BYTE);
+    return len;
+}
+
+/* 检查消息长度是否合法 */
+#define msgbuffer_length_is_valid(msg_buffer, len) \
+    (((len) > 0U) && ((len) <= MSGBUFFER_MSG_MAX_SIZE) && ((len) + MSGBUFFER_LENGTH_BYTE <= (msg_buffer)->buffer_size))
+
+/* 写入一条消息, 需在屏蔽中断时调用 */
+static inline void msgbuffer_do_send(struct msgbuffer *const msg_buffer, const void *const data, const size_t len) {
+    const uint16_t prefix = (uint16_t)len;
+
+    size_t pos = msgbuffer_copy_in(msg_buffer, msg_buffer->write_pos, (const byte *)&prefix, MSGBUFFER_LENGTH_BYTE);
+    msg_buffer->write_pos = msgbuffer_copy_in(msg_buffer, pos, (const byte *)data, len);
+
+    msg_buffer->used_size += len + MSGBUFFER_LENGTH_BYTE;
+    ++(msg_buffer->msg_count);
+
+    /* 达到触发等级, 唤醒等待接收消息的任务 */
+    if (msg_buffer->used_size >= msg_buffer->trigger_level) {
+        msgbuffer_wake_all(msg_buffer->tasks_waiting_to_receive);
+    }
+}
+
+/* 读出一条消息, 需在屏蔽中断时调用 */
+static inline size_t msgbuffer_do_receive(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len) {
+    const size_t len = msgbuffer_peek_length(msg_buffer);
+
+    /* 存放缓冲区不足, 消息保留在缓冲区中 */
+    if (len > max_len) {
+        return 0U;
+    }
+
+    size_t pos = msg_buffer->read_pos + MSGBUFFER_LENGTH_BYTE;
+    if (pos >= msg_buffer->buffer_size) {
+        pos -= msg_buffer->buffer_size;
+    }
+    msg_buffer->read_pos = msgbuffer_copy_out(msg_buffer, pos, (byte *)data, len);
+
+    msg_buffer->used_size -= len + MSGBUFFER_LENGTH_BYTE;
+    --(msg_buffer->msg_count);
+
+    /* 唤醒等待发送消息的任务 */
+    msgbuffer_wake_all(msg_buffer->tasks_waiting_to_send);
+
+    return len;
+}
+
+/* 发送消息 */
+bool msgbuffer_send(struct msgbuffer *const msg_buffer, const void *const data, const size_t len) {
+    assert(msg_buffer != NULL);
+    assert(data != NULL);
+
+    if (!msgbuffer_length_is_valid(msg_buffer, len)) {
+        return false;
+    }
+
+    while (true) {
+        bool is_sent = false;
+
+        /* 检查空间与写入在同一临界区内完成, 避免与中断中的收发竞争 */
+        atomic({
+            if (msgbuffer_free_size(msg_buffer) >= len + MSGBUFFER_LENGTH_BYTE) {
+                msgbuffer_do_send(msg_buffer, data, len);
+                is_sent = true;
+            } else {
+                /* 缓冲区已无法容纳更多数据, 不必再等待触发等级 */
+                if (msg_buffer->msg_count > 0U) {
+                    msgbuffer_wake_all(msg_buffer->tasks_waiting_to_receive);
+                }
+
+                msgbuffer_block_current_task(msg_buffer->tasks_waiting_to_send);
+            }
+        });
+
+        if (is_sent) {
+            break;
+        }
+
+        task_yield();
+    }
+
+    return true;
+}
+
+bool msgbuffer_send_from_isr(struct msgbuffer *const msg_buffer, const void *const data, const size_t len) {
+    assert(msg_buffer != NULL);
+    assert(data != NULL);
+
+    if (!msgbuffer_length_is_valid(msg_buffer, len)) {
+        return false;
+    }
+
+    bool is_sent = false;
+
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    if (msgbuffer_free_size(msg_buffer) >= len + MSGBUFFER_LENGTH_BYTE) {
+        msgbuffer_do_send(msg_buffer, data, len);
+        is_sent = true;
+    }
+
+    irq_enable_from_isr(prev_basepri);
+
+    return is_sent;
+}
+
+/* 接收消息 */
+static size_t msgbuffer_receive_common(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len,
+                                       const bool has_timeout, tick_t timeout) {
+    assert(msg_buffer != NULL);
+    assert(data != NULL);
+
+    tick_t current_tick = tick_get_current();
+
+    while (true) {
+        bool has_msg = false;
+        size_t len = 0U;
+
+        atomic({
+            if (msg_buffer->msg_count > 0U) {
+                len = msgbuffer_do_receive(msg_buffer, data, max_len);
+                has_msg = true;
+            } else if (!has_timeout) {
+                msgbuffer_block_current_task(msg_buffer->tasks_waiting_to_receive);
+            }
+        });
+
+        if (has_msg) {
+            return len;
+        }
+
+        /* 超时处理 */
+        if (has_timeout) {
+            if (timeout == 0) {
+                return 0U;
+            }
+
+            if (tick_after(tick_get_current(), current_tick + 1)) {
+                current_tick = tick_get_current();
+                --timeout;
+            }
+        }
+
+        task_yield();
+    }
+}
+
+size_t msgbuffer_receive(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len) {
+    return msgbuffer_receive_common(msg_buffer, data, max_len, false, 0);
+}
+
+size_t msgbuffer_try_receive(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len,
+                             const tick_t timeout) {
+    return msgbuffer_receive_common(msg_buffer, data, max_len, true, timeout);
+}
+
+size_t msgbuffer_receive_from_isr(struct msgbuffer *const msg_buffer, void *const data, const size_t max_len) {
+    assert(msg_buffer != NULL);
+    assert(data != NULL);
+
+    size_t len = 0U;
+
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    if (msg_buffer->msg_count > 0U) {
+        len = msgbuffer_do_receive(msg_buffer, data, max_len);
+    }
+
+    irq_enable_from_isr(prev_basepri);
+
+    return len;
+}
+
+size_t msgbuffer_get_next_length(struct msgbuffer *const msg_buffer) {
+    assert(msg_buffer != NULL);
+
+    size_t len = 0U;
+
+    atomic({
+        if (msg_buffer->msg_count > 0U) {
+            len = msgbuffer_peek_length(msg_buffer);
+        }
+    });
+
+    return len;
+}
+
+size_t msgbuffer_get_free_size(const struct msgbuffer *const msg_buffer) {
+    assert(msg_buffer != NULL);
+
+    return msgbuffer_free_size(msg_buffer);
+}
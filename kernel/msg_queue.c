@@ -1,3 +1,4 @@
+#include <config.h>
 #include <string.h>
 #include <zhiyec/assert.h>
 #include <zhiyec/atomic.h>
@@ -5,29 +6,12 @@
 #include <zhiyec/msg_queue.h>
 #include <zhiyec/task_list.h>
 
-struct msgqueue {
-    /* 数据缓冲区 */
-    void *buffer;
-    /* 缓冲区大小 */
-    size_t buffer_size;
-    /* 类型大小 */
-    size_t type_size;
-    /* 等待发送消息的任务 */
-    struct stack_list tasks_waiting_to_send;
-    /* 等待接收消息的任务 */
-    struct stack_list tasks_waiting_to_receive;
-    /* 等待接收消息的任务数 */
-    volatile size_t task_waiting_to_receive_count;
-
-    /* 队头指针（出队位置） */
-    size_t queue_head;
-    /* 队尾指针（入队位置） */
-    size_t queue_tail;
-    /* 当前队列元素数量 */
-    volatile size_t queue_count;
-};
-
-static_assert(MSGQUEUE_BYTE == sizeof(struct msgqueue), "size mismatch");
+#if (USE_QUEUE_SET)
+#include <zhiyec/queue_set.h>
+#endif
+#if (USE_KERNEL_INTROSPECTION)
+#include <zhiyec/kobject.h>
+#endif
 
 /* 初始化消息队列 */
 struct msgqueue *msgqueue_init(void *const msg_queue_mem,
@@ -46,22 +30,47 @@ struct msgqueue *msgqueue_init(void *const msg_queue_mem,
     msg_queue->queue_head = 0U;
     msg_queue->queue_tail = 0U;
     msg_queue->queue_count = 0U;
+#if (USE_QUEUE_SET)
+    msg_queue->queue_set = NULL;
+#endif /* USE_QUEUE_SET */
 
     return msg_queue;
 }
 
-/* 检查队列是否为空 */
-#define msgqueue_is_empty(msg_queue) ((msg_queue)->queue_count == 0)
+/* 计算下一个位置(运行时容量, 以比较代替取模) */
+#define msgqueue_advance(msg_queue, index) \
+    (((index) + 1U == (msg_queue)->buffer_size) ? (size_t)0U : ((index) + 1U))
 
-/* 检查队列是否已满 */
-#define msgqueue_is_full(msg_queue) ((msg_queue)->queue_count == (msg_queue)->buffer_size)
+/* 获取消息在缓冲区中的地址 */
+#define msgqueue_slot(msg_queue, index) \
+    ((unsigned char *)((msg_queue)->buffer) + ((msg_queue)->type_size * (index)))
 
-static inline void msgqueue_do_send(struct msgqueue *const msg_queue, const void *const data) {
-    /* 往消息队列添加消息 */
-    unsigned char *const writer = (unsigned char *)(msg_queue->buffer) + (msg_queue->type_size * msg_queue->queue_tail);
-    memcpy(writer, data, msg_queue->type_size);
+/* 等待队列出现空位 */
+void msgqueue_wait_to_send(struct msgqueue *const msg_queue) {
+    assert(msg_queue != NULL);
+
+    while (true) {
+        atomic_begin();
+
+        /* 检查与写入在同一临界区内完成 */
+        if (!msgqueue_is_full(msg_queue)) {
+            break;
+        }
+
+        struct slist_head *const front_node = tasklist_remove_front(task_get_priority(task_get_current()));
+
+        if (front_node) {
+            stack_list_push(msg_queue->tasks_waiting_to_send, front_node);
+        }
+
+        atomic_end();
+        task_yield();
+    }
+}
 
-    msg_queue->queue_tail = (msg_queue->queue_tail + 1) % msg_queue->buffer_size;
+/* 提交消息 */
+void msgqueue_commit_send(struct msgqueue *const msg_queue, const size_t next_tail) {
+    msg_queue->queue_tail = next_tail;
     ++(msg_queue->queue_count);
 
     /* 唤醒等待接收消息的任务 */
@@ -71,6 +80,13 @@ static inline void msgqueue_do_send(struct msgqueue *const msg_queue, const void
 
         tasklist_append(task_get_priority(task_get_from_node(node)), node);
     }
+
+#if (USE_QUEUE_SET)
+    /* 通知所属的队列集合 */
+    if (msg_queue->queue_set != NULL) {
+        queueset_notify(msg_queue->queue_set, msg_queue);
+    }
+#endif
 }
 
 /* 发送消息 */
@@ -78,25 +94,13 @@ bool msgqueue_send(struct msgqueue *const msg_queue, const void *const data) {
     assert(msg_queue != NULL);
     assert(data != NULL);
 
-    while (true) {
-        if (!msgqueue_is_full(msg_queue)) {
-            break;
-        }
-
-        task_suspend_all();
-        struct slist_head *const front_node = tasklist_remove_front(task_get_priority(task_get_current()));
-
-        if (front_node) {
-            stack_list_push(msg_queue->tasks_waiting_to_send, front_node);
-        }
+    msgqueue_wait_to_send(msg_queue);
 
-        task_resume_all();
-        task_yield();
-    }
+    /* 往消息队列添加消息 */
+    memcpy(msgqueue_slot(msg_queue, msg_queue->queue_tail), data, msg_queue->type_size);
+    msgqueue_commit_send(msg_queue, msgqueue_advance(msg_queue, msg_queue->queue_tail));
 
-    atomic({
-        msgqueue_do_send(msg_queue, data);
-    });
+    atomic_end();
 
     return true;
 }
@@ -105,22 +109,24 @@ bool msgqueue_send_from_isr(struct msgqueue *const msg_queue, const void *const
     assert(msg_queue != NULL);
     assert(data != NULL);
 
-    if (msgqueue_is_full(msg_queue)) {
-        return false;
-    }
+    bool is_sent = false;
 
     uint32_t prev_basepri = irq_disable_from_isr();
-    msgqueue_do_send(msg_queue, data);
+
+    if (!msgqueue_is_full(msg_queue)) {
+        memcpy(msgqueue_slot(msg_queue, msg_queue->queue_tail), data, msg_queue->type_size);
+        msgqueue_commit_send(msg_queue, msgqueue_advance(msg_queue, msg_queue->queue_tail));
+        is_sent = true;
+    }
+
     irq_enable_from_isr(prev_basepri);
 
-    return true;
+    return is_sent;
 }
 
-/* 接收消息 */
-static bool msgqueue_do_receive(struct msgqueue *const msg_queue, void *const data,
-                                const bool has_timeout, tick_t timeout) {
+/* 等待队列中出现消息 */
+bool msgqueue_wait_to_receive(struct msgqueue *const msg_queue, const bool has_timeout, tick_t timeout) {
     assert(msg_queue != NULL);
-    assert(data != NULL);
 
     tick_t current_tick = tick_get_current();
 
@@ -172,12 +178,13 @@ static bool msgqueue_do_receive(struct msgqueue *const msg_queue, void *const da
         --(msg_queue->task_waiting_to_receive_count);
     });
 
-    /* 从消息队列中读取消息 */
-    const unsigned char *const reader = (unsigned char *)(msg_queue->buffer) + (msg_queue->type_size * msg_queue->queue_head);
-    memcpy(data, reader, msg_queue->type_size);
+    return true;
+}
 
+/* 提交读取 */
+void msgqueue_commit_receive(struct msgqueue *const msg_queue, const size_t next_head) {
     if (msg_queue->task_waiting_to_receive_count == 0U) {
-        msg_queue->queue_head = (msg_queue->queue_head + 1) % msg_queue->buffer_size;
+        msg_queue->queue_head = next_head;
         --(msg_queue->queue_count);
 
         /* 唤醒一个等待发送消息的任务 */
@@ -194,6 +201,22 @@ static bool msgqueue_do_receive(struct msgqueue *const msg_queue, void *const da
     if (msg_queue->task_waiting_to_receive_count != 0U) {
         task_yield();
     }
+}
+
+/* 接收消息 */
+static bool msgqueue_do_receive(struct msgqueue *const msg_queue, void *const data,
+                                const bool has_timeout, tick_t timeout) {
+    assert(msg_queue != NULL);
+    assert(data != NULL);
+
+    if (!msgqueue_wait_to_receive(msg_queue, has_timeout, timeout)) {
+        return false;
+    }
+
+    /* 从消息队列中读取消息 */
+    memcpy(data, msgqueue_slot(msg_queue, msg_queue->queue_head), msg_queue->type_size);
+
+    msgqueue_commit_receive(msg_queue, msgqueue_advance(msg_queue, msg_queue->queue_head));
 
     return true;
 }
@@ -206,3 +229,26 @@ bool msgqueue_try_receive(struct msgqueue *const msg_queue, void *const data,
                           const tick_t timeout) {
     return msgqueue_do_receive(msg_queue, data, true, timeout);
 }
+
+#if (USE_KERNEL_INTROSPECTION)
+/* 获取内核对象信息 */
+void msgqueue_get_kobject_info(const void *object, struct kobject_info *info) {
+    const struct msgqueue *const msg_queue = (const struct msgqueue *)object;
+
+    size_t waiting_count = 0U;
+
+    atomic({
+        info->value = msg_queue->queue_count;
+        waiting_count = msg_queue->task_waiting_to_receive_count;
+
+        for (struct slist_head *node = stack_list_front(msg_queue->tasks_waiting_to_send);
+             node != NULL; node = node->next) {
+            ++waiting_count;
+        }
+    });
+
+    info->type = "msgqueue";
+    info->capacity = msg_queue->buffer_size;
+    info->waiting_count = waiting_count;
+}
+#endif /* USE_KERNEL_INTROSPECTION */
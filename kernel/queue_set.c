@@ -0,0 +1,190 @@
+#include <config.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/list.h>
+#include <zhiyec/queue_set.h>
+#include <zhiyec/task_list.h>
+
+#if (!USE_QUEUE_SET)
+#error please set USE_QUEUE_SET to 1 or remove this file from your project.
+#endif
+
+struct queueset {
+    /* 就绪事件缓冲区 */
+    void **buffer;
+    /* 缓冲区大小 */
+    size_t buffer_size;
+    /* 队头指针（出队位置） */
+    size_t queue_head;
+    /* 队尾指针（入队位置） */
+    size_t queue_tail;
+    /* 当前就绪事件数量 */
+    volatile size_t queue_count;
+    /* 成员容量之和(消息队列的容量与信号量的最大计数值), 不超过缓冲区大小 */
+    size_t member_capacity;
+    /* 缓冲区满时丢弃的事件数 */
+    volatile size_t dropped_count;
+    /* 等待对象就绪的任务 */
+    struct queue_list tasks_waiting_to_select;
+};
+
+static_assert(QUEUESET_BYTE == sizeof(struct queueset), "size mismatch");
+
+/* 初始化队列集合 */
+struct queueset *queueset_init(void *const queue_set_mem, void **const buffer, const size_t buffer_size) {
+    assert(queue_set_mem != NULL);
+    assert(buffer != NULL);
+
+    struct queueset *queue_set = (struct queueset *)queue_set_mem;
+
+    queue_set->buffer = buffer;
+    queue_set->buffer_size = buffer_size;
+    queue_set->queue_head = 0U;
+    queue_set->queue_tail = 0U;
+    queue_set->queue_count = 0U;
+    queue_set->member_capacity = 0U;
+    queue_set->dropped_count = 0U;
+    queue_list_init(queue_set->tasks_waiting_to_select);
+
+    return queue_set;
+}
+
+/* 通知成员就绪 */
+void queueset_notify(struct queueset *const queue_set, void *const member) {
+    /**
+     * 成员容量之和不超过缓冲区大小, 按 select 后接收或获取一次的方式使用时缓冲区不会满;
+     * 绕过 select 直接接收或获取会留下多余的事件, 此时缓冲区可能满, 丢弃该事件并计数
+     */
+    if (queue_set->queue_count == queue_set->buffer_size) {
+        ++(queue_set->dropped_count);
+        return;
+    }
+
+    queue_set->buffer[queue_set->queue_tail] = member;
+    queue_set->queue_tail = (queue_set->queue_tail + 1U == queue_set->buffer_size) ? 0U : queue_set->queue_tail + 1U;
+    ++(queue_set->queue_count);
+
+    /* 每个事件只唤醒一个等待的任务 */
+    if (!queue_list_is_empty(queue_set->tasks_waiting_to_select)) {
+        struct slist_head *const node = queue_list_front(queue_set->tasks_waiting_to_select);
+        queue_list_pop(queue_set->tasks_waiting_to_select);
+
+        tasklist_append(task_get_priority(task_get_from_node(node)), node);
+    }
+}
+
+/* 将消息队列加入集合 */
+bool queueset_add_msgqueue(struct queueset *const queue_set, struct msgqueue *const msg_queue) {
+    assert(queue_set != NULL);
+    assert(msg_queue != NULL);
+
+    bool is_added = false;
+
+    atomic({
+        if (msg_queue->queue_set == NULL &&
+            queue_set->member_capacity + msg_queue->buffer_size <= queue_set->buffer_size) {
+            msg_queue->queue_set = queue_set;
+            queue_set->member_capacity += msg_queue->buffer_size;
+
+            for (size_t i = 0; i < msg_queue->queue_count; ++i) {
+                queueset_notify(queue_set, msg_queue);
+            }
+
+            is_added = true;
+        }
+    });
+
+    return is_added;
+}
+
+/* 将信号量加入集合 */
+bool queueset_add_semaphore(struct queueset *const queue_set, struct semaphore *const sem) {
+    assert(queue_set != NULL);
+    assert(sem != NULL);
+
+    bool is_added = false;
+
+    atomic({
+        const size_t capacity = (size_t)semaphore_get_max_value(sem);
+
+        if (semaphore_get_queueset(sem) == NULL && queue_set->member_capacity + capacity <= queue_set->buffer_size) {
+            semaphore_set_queueset(sem, queue_set);
+            queue_set->member_capacity += capacity;
+
+            for (int i = 0; i < semaphore_get_value(sem); ++i) {
+                queueset_notify(queue_set, sem);
+            }
+
+            is_added = true;
+        }
+    });
+
+    return is_added;
+}
+
+/* 取出一个就绪事件, 需在屏蔽中断时调用 */
+static inline void *queueset_pop(struct queueset *const queue_set) {
+    void *const member = queue_set->buffer[queue_set->queue_head];
+
+    queue_set->queue_head = (queue_set->queue_head + 1U == queue_set->buffer_size) ? 0U : queue_set->queue_head + 1U;
+    --(queue_set->queue_count);
+
+    return member;
+}
+
+/* 等待成员就绪 */
+static void *queueset_do_select(struct queueset *const queue_set, const bool has_timeout, tick_t timeout) {
+    assert(queue_set != NULL);
+
+    tick_t current_tick = tick_get_current();
+
+    while (true) {
+        void *member = NULL;
+
+        atomic({
+            if (queue_set->queue_count > 0U) {
+                member = queueset_pop(queue_set);
+            } else if (!has_timeout) {
+                /* 进入阻塞 */
+                struct slist_head *const front_node = tasklist_remove_front(task_get_priority(task_get_current()));
+
+                if (front_node) {
+                    queue_list_push(queue_set->tasks_waiting_to_select, front_node);
+                }
+            }
+        });
+
+        if (member != NULL) {
+            return member;
+        }
+
+        /* 超时处理 */
+        if (has_timeout) {
+            if (timeout == 0) {
+                return NULL;
+            }
+
+            if (tick_after(tick_get_current(), current_tick + 1)) {
+                current_tick = tick_get_current();
+                --timeout;
+            }
+        }
+
+        task_yield();
+    }
+}
+
+void *queueset_select(struct queueset *const queue_set) {
+    return queueset_do_select(queue_set, false, 0);
+}
+
+void *queueset_try_select(struct queueset *const queue_set, const tick_t timeout) {
+    return queueset_do_select(queue_set, true, timeout);
+}
+
+/* 获取丢弃的事件数 */
+size_t queueset_get_dropped(const struct queueset *const queue_set) {
+    assert(queue_set != NULL);
+
+    return queue_set->dropped_count;
+}
@@ -1,3 +1,4 @@
+#include <config.h>
 #include <stddef.h>
 #include <zhiyec/assert.h>
 #include <zhiyec/atomic.h>
@@ -6,6 +7,13 @@
 #include <zhiyec/semaphore.h>
 #include <zhiyec/task_list.h>
 
+#if (USE_QUEUE_SET)
+#include <zhiyec/queue_set.h>
+#endif
+#if (USE_KERNEL_INTROSPECTION)
+#include <zhiyec/kobject.h>
+#endif
+
 struct semaphore {
     /* 信号量状态 */
     volatile int state;
@@ -13,6 +21,10 @@ struct semaphore {
     int max_value;
     /* 等待获得信号量的任务 */
     struct queue_list tasks_waiting_to_acquire;
+#if (USE_QUEUE_SET)
+    /* 所属的队列集合 */
+    struct queueset *queue_set;
+#endif /* USE_QUEUE_SET */
 };
 
 static_assert(SEMAPHORE_BYTE == sizeof(struct semaphore), "size mismatch");
@@ -26,6 +38,9 @@ struct semaphore *semaphore_init_binary(void *const sem_mem) {
     sem->state = 1;
     sem->max_value = 1;
     queue_list_init(sem->tasks_waiting_to_acquire);
+#if (USE_QUEUE_SET)
+    sem->queue_set = NULL;
+#endif /* USE_QUEUE_SET */
 
     return sem;
 }
@@ -40,6 +55,9 @@ struct semaphore *semaphore_init_counting(void *const sem_mem,
     sem->state = init_value;
     sem->max_value = max_value;
     queue_list_init(sem->tasks_waiting_to_acquire);
+#if (USE_QUEUE_SET)
+    sem->queue_set = NULL;
+#endif /* USE_QUEUE_SET */
 
     return sem;
 }
@@ -108,6 +126,18 @@ bool semaphore_try_acquire(struct semaphore *const sem, tick_t timeout) {
     return true;
 }
 
+/* 通知所属的队列集合, 需在屏蔽中断时调用 */
+#if (USE_QUEUE_SET)
+#define semaphore_notify_queueset(sem)                      \
+    do {                                                    \
+        if ((sem)->queue_set != NULL && (sem)->state > 0) { \
+            queueset_notify((sem)->queue_set, (sem));       \
+        }                                                   \
+    } while (0)
+#else
+#define semaphore_notify_queueset(sem) ((void)0)
+#endif /* USE_QUEUE_SET */
+
 /* 释放信号量 */
 void semaphore_release(struct semaphore *const sem) {
     assert(sem != NULL);
@@ -117,6 +147,7 @@ void semaphore_release(struct semaphore *const sem) {
     atomic({
         if (sem->state < sem->max_value) {
             ++(sem->state);
+            semaphore_notify_queueset(sem);
         }
     });
 
@@ -162,7 +193,53 @@ void semaphore_release_from_isr(struct semaphore *const sem) {
 
     if (sem->state < sem->max_value) {
         ++(sem->state);
+        semaphore_notify_queueset(sem);
     }
 
     irq_enable_from_isr(prev_basepri);
 }
+
+#if (USE_QUEUE_SET)
+/* 获取计数值 */
+int semaphore_get_value(const struct semaphore *const sem) {
+    assert(sem != NULL);
+
+    return sem->state;
+}
+
+/* 获取最大计数值 */
+int semaphore_get_max_value(const struct semaphore *const sem) {
+    assert(sem != NULL);
+
+    return sem->max_value;
+}
+
+/* 获取所属的队列集合 */
+struct queueset *semaphore_get_queueset(const struct semaphore *const sem) {
+    assert(sem != NULL);
+
+    return sem->queue_set;
+}
+
+/* 设置所属的队列集合 */
+void semaphore_set_queueset(struct semaphore *const sem, struct queueset *const queue_set) {
+    assert(sem != NULL);
+
+    sem->queue_set = queue_set;
+}
+#endif /* USE_QUEUE_SET */
+
+#if (USE_KERNEL_INTROSPECTION)
+/* 获取内核对象信息 */
+void semaphore_get_kobject_info(const void *object, struct kobject_info *info) {
+    const struct semaphore *const sem = (const struct semaphore *)object;
+
+    /* 计数值为负数时表示等待的任务数 */
+    const int state = sem->state;
+
+    info->type = "semaphore";
+    info->value = (state > 0) ? (size_t)state : 0U;
+    info->capacity = (size_t)sem->max_value;
+    info->waiting_count = (state < 0) ? (size_t)(-state) : 0U;
+}
+#endif /* USE_KERNEL_INTROSPECTION */
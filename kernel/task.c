@@ -22,6 +22,15 @@ static bool blocked_task_list_ready_switch_next_cycle = false;
 /* 等待删除任务列表 */
 static struct stack_list to_delete_task_list;
 
+#if (USE_KERNEL_INTROSPECTION)
+/* 所有任务的列表 */
+static struct stack_list task_registry;
+/* 任务列表的修改计数, 用于检测快照过程中的任务创建和删除 */
+static volatile uint32_t task_registry_generation = 0U;
+
+static void task_registry_remove(struct task_struct *const task);
+#endif /* USE_KERNEL_INTROSPECTION */
+
 static struct task_struct *task_new_task_struct(stack_t *const stack, stack_t *const top_of_stack);
 static void task_delete_task_struct(struct task_struct *const task);
 void task_return_handler(void);
@@ -38,6 +47,13 @@ bool task_create(void (*const fn)(void *), void *const arg, stack_t *const stack
     /* 内存对齐 */
     top_of_stack = (stack_t *)(((stack_t)top_of_stack) & ~((stack_t)(BYTE_ALIGNMENT - 1)));
 
+#if (USE_KERNEL_INTROSPECTION)
+    /* 填充任务栈, 用于统计栈的最大用量 */
+    for (stack_t i = 0U; i < stack_size; ++i) {
+        stack[i] = TASK_STACK_FILL_PATTERN;
+    }
+#endif /* USE_KERNEL_INTROSPECTION */
+
     /* 初始化任务栈 */
     top_of_stack = port_init_task_stack(top_of_stack, fn, arg,
                                         task_return_handler);
@@ -61,6 +77,12 @@ bool task_create(void (*const fn)(void *), void *const arg, stack_t *const stack
     task->attr.sched_method = attr->sched_method;
     task->attr.destroy = attr->destroy;
 
+#if (USE_KERNEL_INTROSPECTION)
+    task->attr.name = attr->name;
+    task->stack_size = stack_size;
+    task->run_ticks = 0U;
+#endif /* USE_KERNEL_INTROSPECTION */
+
     /* 添加到任务列表 */
     atomic({
         if (!tasklist_is_init()) {
@@ -69,6 +91,11 @@ bool task_create(void (*const fn)(void *), void *const arg, stack_t *const stack
 
         tasklist_append(task->attr.priority, &(task->task_node));
 
+    #if (USE_KERNEL_INTROSPECTION)
+        stack_list_push(task_registry, &(task->registry_node));
+        ++task_registry_generation;
+    #endif /* USE_KERNEL_INTROSPECTION */
+
         if (kernel_current_task == NULL) {
             kernel_current_task = task;
         }
@@ -117,6 +144,9 @@ static inline void task_do_sleep(const tick_t resume_time) {
 
             if (front_node != NULL) {
                 task_get_from_node(front_node)->resume_time = resume_time;
+            #if (USE_KERNEL_INTROSPECTION)
+                task_get_from_node(front_node)->state = TASKSTATE_SLEEPING;
+            #endif /* USE_KERNEL_INTROSPECTION */
 
                 const tick_t current_time = tick_get_current();
 
@@ -152,6 +182,9 @@ void task_delete_later() {
         struct slist_head *const front_node = tasklist_remove_front(kernel_current_task->attr.priority);
 
         if (front_node != NULL) {
+        #if (USE_KERNEL_INTROSPECTION)
+            task_get_from_node(front_node)->state = TASKSTATE_DELETED;
+        #endif /* USE_KERNEL_INTROSPECTION */
             stack_list_push(to_delete_task_list, front_node);
         }
     });
@@ -201,6 +234,10 @@ static void kernel_idle_task(void *arg) {
                     task->attr.destroy(task->stack);
                 }
 
+            #if (USE_KERNEL_INTROSPECTION)
+                task_registry_remove(task);
+            #endif /* USE_KERNEL_INTROSPECTION */
+
                 /* 删除对象 */
                 task_delete_task_struct(task);
             }
@@ -218,6 +255,9 @@ static void kernel_idle_task(void *arg) {
 int task_schedule() {
     const struct task_attribute idle_task_attr = {
         .priority = TASKPRIO_IDLE,
+#if (USE_KERNEL_INTROSPECTION)
+        .name = "idle",
+#endif /* USE_KERNEL_INTROSPECTION */
     };
 
     /* 尝试创建空闲任务 */
@@ -250,12 +290,21 @@ static struct task_struct *task_new_task_struct(stack_t *const stack,
         new_task->stack = stack;
         new_task->top_of_stack = top_of_stack;
         new_task->resume_time = 0U;
+        stack_list_init(new_task->owned_memory);
     }
 
     return new_task;
 }
 
 static void task_delete_task_struct(struct task_struct *const task) {
+    /* 释放任务拥有的内存块 */
+    while (!stack_list_is_empty(task->owned_memory)) {
+        struct slist_head *const node = stack_list_front(task->owned_memory);
+        stack_list_pop(task->owned_memory);
+
+        memory_free(node);
+    }
+
     memory_free(task);
 }
 
@@ -314,6 +363,11 @@ bool task_need_switch() {
     /* 内核Tick计数 */
     ++kernel_ticks;
 
+#if (USE_KERNEL_INTROSPECTION)
+    /* 统计当前任务的运行时间 */
+    ++kernel_current_task->run_ticks;
+#endif /* USE_KERNEL_INTROSPECTION */
+
     /* 检测到Tick计数溢出, 准备切换到下一个Tick周期 */
     if (tick_get_current() == 0U) {
         blocked_task_list_ready_switch_next_cycle = true;
@@ -368,3 +422,122 @@ void task_switch_next() {
     tasklist_get_highest_priority(priority);
     kernel_current_task = tasklist_get_front_task(priority);
 }
+
+#if (USE_KERNEL_INTROSPECTION)
+/* 从任务列表中移除任务(需在屏蔽中断时调用) */
+static void task_registry_remove(struct task_struct *const task) {
+    struct slist_head *prev_node = NULL;
+
+    for (struct slist_head *node = stack_list_front(task_registry); node != NULL; node = node->next) {
+        if (node == &(task->registry_node)) {
+            if (prev_node != NULL) {
+                prev_node->next = node->next;
+            } else {
+                stack_list_pop(task_registry);
+            }
+            ++task_registry_generation;
+            return;
+        }
+
+        prev_node = node;
+    }
+}
+
+/* 统计从未使用过的栈大小, 栈向低地址增长, 从栈底开始查找填充值 */
+static size_t task_count_stack_unused(const stack_t *const stack, const size_t stack_size) {
+    size_t unused = 0U;
+
+    while (unused < stack_size && stack[unused] == TASK_STACK_FILL_PATTERN) {
+        ++unused;
+    }
+
+    return unused;
+}
+
+/* 获取任务快照 */
+size_t task_get_snapshot(struct task_snapshot *const snapshots, const size_t max_count) {
+    assert(snapshots != NULL);
+
+    size_t count;
+    uint32_t generation;
+    struct slist_head *node;
+    bool is_changed;
+
+    do {
+        count = 0U;
+        is_changed = false;
+
+        atomic_begin();
+        generation = task_registry_generation;
+        node = stack_list_front(task_registry);
+        atomic_end();
+
+        while (node != NULL && count < max_count) {
+            struct task_snapshot *const snapshot = &snapshots[count];
+            const stack_t *stack = NULL;
+
+            /* 每次只在屏蔽中断时复制一个任务 */
+            atomic_begin();
+            if (generation != task_registry_generation) {
+                is_changed = true;
+            } else {
+                const struct task_struct *const task = container_of(node, struct task_struct, registry_node);
+
+                snapshot->task = task;
+                snapshot->name = task->attr.name;
+                snapshot->priority = task->attr.priority;
+                snapshot->sched_method = task->attr.sched_method;
+                snapshot->state = (task == kernel_current_task) ? TASKSTATE_RUNNING : task->state;
+                snapshot->resume_time = task->resume_time;
+                snapshot->run_ticks = task->run_ticks;
+                snapshot->stack_size = task->stack_size;
+                stack = task->stack;
+
+                node = node->next;
+            }
+            atomic_end();
+
+            if (is_changed) {
+                break;
+            }
+
+            /* 栈用量在屏蔽中断之外统计 */
+            snapshot->stack_unused = task_count_stack_unused(stack, snapshot->stack_size);
+            ++count;
+        }
+
+        /* 统计栈用量期间任务可能被删除, 重新获取 */
+        if (generation != task_registry_generation) {
+            is_changed = true;
+        }
+    } while (is_changed);
+
+    return count;
+}
+
+/* 获取调度器快照 */
+void task_get_sched_snapshot(struct task_sched_snapshot *const snapshot) {
+    assert(snapshot != NULL);
+
+    size_t task_count = 0U;
+    size_t sleeping_count = 0U;
+
+    atomic_begin();
+    snapshot->ticks = tick_get_current();
+    snapshot->ready_bitmap = kernel_task_list_bitmap;
+
+    for (struct slist_head *node = stack_list_front(task_registry); node != NULL; node = node->next) {
+        ++task_count;
+    }
+
+    for (size_t i = 0; i < 2; ++i) {
+        for (struct slist_head *node = stack_list_front(blocked_task_list[i]); node != NULL; node = node->next) {
+            ++sleeping_count;
+        }
+    }
+    atomic_end();
+
+    snapshot->task_count = task_count;
+    snapshot->sleeping_count = sleeping_count;
+}
+#endif /* USE_KERNEL_INTROSPECTION */
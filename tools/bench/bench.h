@@ -0,0 +1,86 @@
+/**
+ * @file bench.h
+ * @author Zhiyelah
+ * @brief 性能测试
+ * @note 在目标板上运行, 按SysTick计数测量时钟周期, 结果通过 fmt_printf 输出;
+ *       将需要的 bench_*.c 加入工程, 在调度器启动后于任务中调用对应的测试函数
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include <asm/systick.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility/delay.h>
+#include <zhiyec/tick.h>
+
+/**
+ * @brief 开始测量
+ * @return 开始时的SysTick计数值
+ * @note 测量的时间需小于一个Tick
+ */
+#define bench_begin() ((uint32_t)SYSTICK_VALUE_REG)
+
+/**
+ * @brief 结束测量
+ * @param start bench_begin 的返回值
+ * @return 经过的时钟周期数
+ */
+#define bench_end(start) delay_elapsed_cycles(start)
+
+/**
+ * @brief 获取时钟周期计数, 可测量超过一个Tick的时间
+ * @note 需在中断开启时使用, 约每 2^32 个周期回绕一次
+ */
+static inline uint32_t bench_cycles(void) {
+    tick_t ticks;
+    uint32_t value;
+
+    /* 读取期间发生Tick中断时重新读取 */
+    do {
+        ticks = tick_get_current();
+        value = SYSTICK_VALUE_REG;
+    } while (ticks != tick_get_current());
+
+    return (uint32_t)ticks * (SYSTICK_LOAD_REG + 1U) + (SYSTICK_LOAD_REG - value);
+}
+
+/* 测量结果统计 */
+struct bench_stat {
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    size_t count;
+};
+
+#define BENCH_STAT_INITIALIZER {0U, 0U, 0U}
+
+static inline void bench_stat_add(struct bench_stat *const stat, const uint32_t cycles) {
+    if (cycles > stat->max_cycles) {
+        stat->max_cycles = cycles;
+    }
+    stat->total_cycles += cycles;
+    ++stat->count;
+}
+
+/* 平均周期数 */
+#define bench_stat_avg(stat) ((unsigned long)((stat)->count > 0U ? (stat)->total_cycles / (stat)->count : 0U))
+
+/**
+ * @brief 动态内存分配: 比较TLSF分配器(memory_alloc/memory_free)与原首次适应分配器的最坏情况周期数
+ * @note 需启用 USE_DYNAMIC_MEMORY_ALLOCATION, 见 bench_memory.c
+ */
+void bench_memory(void);
+
+/**
+ * @brief 软件模拟I2C: 比较 i2c_software_write/read 与 I2C_FAST_DEFINE 生成函数的吞吐量(字节/秒)
+ * @note 引脚和设备在 bench_i2c.c 开头配置
+ */
+void bench_i2c(void);
+
+/**
+ * @brief PID控制器: 比较 pid_fixed_cal_output 与 pid_controller_cal_output 的周期数
+ */
+void bench_pid(void);
+
+#endif /* _BENCH_H */
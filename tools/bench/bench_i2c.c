@@ -0,0 +1,153 @@
+#include "bench.h"
+#include <config.h>
+#include <driver/i2c_fast.h>
+#include <driver/i2c_software.h>
+#include <utility/fmt.h>
+
+/**
+ * [测试配置]
+ * 默认为 STM32F1 的 PB6(SCL)/PB7(SDA), 设备为 24C02 类EEPROM(地址0x50)
+ * 可在编译选项中重新定义
+ */
+#ifndef BENCH_I2C_SET_REG
+#define BENCH_I2C_SET_REG 0x40010C10U     // GPIOB->BSRR
+#define BENCH_I2C_RESET_REG 0x40010C14U   // GPIOB->BRR
+#define BENCH_I2C_RESET_SHIFT 0
+#define BENCH_I2C_INPUT_REG 0x40010C08U   // GPIOB->IDR
+#define BENCH_I2C_SCL_MASK (1U << 6)
+#define BENCH_I2C_SDA_MASK (1U << 7)
+#endif
+
+#ifndef BENCH_I2C_DEV_ADDR
+#define BENCH_I2C_DEV_ADDR 0x50U
+#define BENCH_I2C_REG_ADDR 0x00U
+#endif
+
+#define BENCH_I2C_SPEED I2C_FAST_SPEED_FAST // 总线速率
+#define BENCH_I2C_LEN 16U                   // 每次传输的数据长度(不超过EEPROM页大小)
+#define BENCH_I2C_ROUNDS 8                  // 传输次数
+#define BENCH_I2C_WAIT_ACK_US 10U           // i2c_software 等待应答时间
+#define BENCH_I2C_WRITE_CYCLE_US 5000U      // EEPROM写周期, 两次写入之间等待(不计入测量)
+
+I2C_FAST_DEFINE(bench_i2c_fast, BENCH_I2C_SET_REG, BENCH_I2C_RESET_REG, BENCH_I2C_RESET_SHIFT, BENCH_I2C_INPUT_REG,
+                BENCH_I2C_SCL_MASK, BENCH_I2C_SDA_MASK, BENCH_I2C_SPEED);
+
+/* i2c_software 的接口使用相同的引脚, 每次改变电平后延时相同的半周期, 两者的名义总线速率一致 */
+static uint8_t bench_i2c_read_sda(void) {
+    return (*(const volatile uint32_t *)BENCH_I2C_INPUT_REG & BENCH_I2C_SDA_MASK) ? 1U : 0U;
+}
+
+static void bench_i2c_write_pin(const uint32_t mask, const uint8_t bit) {
+    if (bit) {
+        *(volatile uint32_t *)BENCH_I2C_SET_REG = mask;
+    } else {
+        *(volatile uint32_t *)BENCH_I2C_RESET_REG = mask << BENCH_I2C_RESET_SHIFT;
+    }
+    delay_cycles(I2C_FAST_HALF_PERIOD_CYCLES(BENCH_I2C_SPEED));
+}
+
+static void bench_i2c_write_sda(const uint8_t bit) {
+    bench_i2c_write_pin(BENCH_I2C_SDA_MASK, bit);
+}
+
+static void bench_i2c_write_scl(const uint8_t bit) {
+    bench_i2c_write_pin(BENCH_I2C_SCL_MASK, bit);
+}
+
+static i2c_software_interface bench_i2c_software = {
+    .read_sda = bench_i2c_read_sda,
+    .write_sda = bench_i2c_write_sda,
+    .write_scl = bench_i2c_write_scl,
+};
+
+static bool bench_i2c_software_write(uint8_t *const data, const uint16_t len) {
+    return i2c_software_write(&bench_i2c_software, BENCH_I2C_DEV_ADDR, true, BENCH_I2C_REG_ADDR, data, len,
+                              BENCH_I2C_WAIT_ACK_US);
+}
+
+static bool bench_i2c_software_read(uint8_t *const data, const uint16_t len) {
+    return i2c_software_read(&bench_i2c_software, BENCH_I2C_DEV_ADDR, true, BENCH_I2C_REG_ADDR, data, len,
+                             BENCH_I2C_WAIT_ACK_US);
+}
+
+static bool bench_i2c_fast_write_data(uint8_t *const data, const uint16_t len) {
+    return bench_i2c_fast_write(BENCH_I2C_DEV_ADDR, true, BENCH_I2C_REG_ADDR, data, len);
+}
+
+static bool bench_i2c_fast_read_data(uint8_t *const data, const uint16_t len) {
+    return bench_i2c_fast_read(BENCH_I2C_DEV_ADDR, true, BENCH_I2C_REG_ADDR, data, len);
+}
+
+/* 被测试的驱动 */
+struct bench_i2c_driver {
+    const char *name;
+    bool (*write)(uint8_t *data, uint16_t len);
+    bool (*read)(uint8_t *data, uint16_t len);
+};
+
+struct bench_i2c_result {
+    uint64_t bytes;
+    uint64_t cycles;
+};
+
+/* 吞吐量(字节/秒) */
+static unsigned long bench_i2c_bytes_per_second(const struct bench_i2c_result *const result) {
+    return (result->cycles > 0U) ? (unsigned long)(result->bytes * CONFIG_CPU_CLOCK_HZ / result->cycles) : 0UL;
+}
+
+/* 测量一次传输, 成功时累计字节数和周期数 */
+static bool bench_i2c_measure(bool (*const transfer)(uint8_t *data, uint16_t len),
+                              struct bench_i2c_result *const result, uint8_t *const data) {
+    const uint32_t start = bench_cycles();
+    const bool ok = transfer(data, BENCH_I2C_LEN);
+    const uint32_t cycles = bench_cycles() - start;
+
+    if (ok) {
+        result->bytes += BENCH_I2C_LEN;
+        result->cycles += cycles;
+    }
+
+    return ok;
+}
+
+/* 同一组传输分别通过两个驱动执行 */
+static void bench_i2c_run(const struct bench_i2c_driver *const driver) {
+    struct bench_i2c_result write_result = {0U, 0U};
+    struct bench_i2c_result read_result = {0U, 0U};
+    unsigned int failed_count = 0U;
+    uint8_t data[BENCH_I2C_LEN];
+
+    for (int round = 0; round < BENCH_I2C_ROUNDS; ++round) {
+        for (uint16_t i = 0; i < BENCH_I2C_LEN; ++i) {
+            data[i] = (uint8_t)(round + i);
+        }
+
+        if (!bench_i2c_measure(driver->write, &write_result, data)) {
+            ++failed_count;
+        }
+        delay_us(BENCH_I2C_WRITE_CYCLE_US);
+
+        if (!bench_i2c_measure(driver->read, &read_result, data)) {
+            ++failed_count;
+        }
+    }
+
+    fmt_printf("%-12s %12lu %12lu %8u\r\n", driver->name, bench_i2c_bytes_per_second(&write_result),
+               bench_i2c_bytes_per_second(&read_result), failed_count);
+}
+
+/* 软件模拟I2C吞吐量测试 */
+void bench_i2c(void) {
+    const struct bench_i2c_driver drivers[] = {
+        {"i2c_software", bench_i2c_software_write, bench_i2c_software_read},
+        {"i2c_fast", bench_i2c_fast_write_data, bench_i2c_fast_read_data},
+    };
+
+    fmt_printf("i2c: %u bytes x %d rounds, bus %lu Hz (bytes/s)\r\n", BENCH_I2C_LEN, BENCH_I2C_ROUNDS,
+               (unsigned long)BENCH_I2C_SPEED);
+    fmt_printf("%-12s %12s %12s %8s\r\n", "driver", "write", "read", "failed");
+
+    for (size_t i = 0; i < sizeof(drivers) / sizeof(drivers[0]); ++i) {
+        bench_i2c_run(&drivers[i]);
+    }
+}
@@ -0,0 +1,220 @@
+#include "bench.h"
+#include <config.h>
+#include <utility/fmt.h>
+#include <zhiyec/atomic.h>
+#include <zhiyec/compiler.h>
+#include <zhiyec/memory.h>
+#include <zhiyec/task.h>
+#include <zhiyec/types.h>
+
+#if (!USE_DYNAMIC_MEMORY_ALLOCATION)
+#error please set USE_DYNAMIC_MEMORY_ALLOCATION to 1 or remove this file from your project.
+#endif
+
+/* 测试参数 */
+#define BENCH_MEMORY_SLOT_NUM 32      // 同时存在的内存块数量
+#define BENCH_MEMORY_SIZE_MIN 8U      // 最小分配大小
+#define BENCH_MEMORY_SIZE_MAX 64U     // 最大分配大小
+#define BENCH_MEMORY_CHURN 2000       // 随机分配/释放次数
+#define BENCH_MEMORY_POOL_SIZE 4096   // 首次适应分配器的内存池大小
+
+/**
+ * 原首次适应分配器(TLSF替换之前的 kernel/memory.c), 仅用于对比
+ * 已分配的块按地址排成链表, 分配时从头查找第一个足够大的间隙, 释放时从头查找前一个块
+ */
+struct bench_ff_block {
+    struct bench_ff_block *next;
+    size_t size;
+};
+
+#define BENCH_FF_HEADER_SIZE ((sizeof(struct bench_ff_block) + (BYTE_ALIGNMENT - 1)) & ~(BYTE_ALIGNMENT - 1))
+
+static byte bench_ff_pool[BENCH_MEMORY_POOL_SIZE] aligned(BYTE_ALIGNMENT);
+static byte *bench_ff_end;
+static struct bench_ff_block *bench_ff_head;
+static size_t bench_ff_free_size;
+
+static void bench_ff_init(void) {
+    bench_ff_head = (struct bench_ff_block *)bench_ff_pool;
+    bench_ff_head->next = NULL;
+    bench_ff_head->size = BENCH_FF_HEADER_SIZE;
+    bench_ff_free_size = BENCH_MEMORY_POOL_SIZE;
+    bench_ff_end =
+        (byte *)(((size_t)bench_ff_pool + BENCH_MEMORY_POOL_SIZE - BENCH_FF_HEADER_SIZE) & ~(BYTE_ALIGNMENT - 1));
+}
+
+static void *bench_ff_alloc(size_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+
+    size += BENCH_FF_HEADER_SIZE;
+
+    if (size & (BYTE_ALIGNMENT - 1)) {
+        size += BYTE_ALIGNMENT - (size & (BYTE_ALIGNMENT - 1));
+    }
+
+    if (bench_ff_free_size < size) {
+        return NULL;
+    }
+
+    atomic_begin();
+
+    struct bench_ff_block *current = bench_ff_head;
+
+    while (current->next != NULL) {
+        if ((size_t)((byte *)current->next - ((byte *)current + current->size)) >= size) {
+            break;
+        }
+        current = current->next;
+    }
+
+    byte *const allocated = (byte *)current + current->size;
+
+    if (current->next == NULL && allocated + size > bench_ff_end) {
+        atomic_end();
+        return NULL;
+    }
+
+    struct bench_ff_block *const block = (struct bench_ff_block *)allocated;
+
+    block->next = current->next;
+    block->size = size;
+    current->next = block;
+    bench_ff_free_size -= size;
+
+    atomic_end();
+
+    return (void *)(allocated + BENCH_FF_HEADER_SIZE);
+}
+
+static void bench_ff_free(void *const ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    const struct bench_ff_block *const block = (struct bench_ff_block *)((byte *)ptr - BENCH_FF_HEADER_SIZE);
+
+    atomic({
+        struct bench_ff_block *prev = bench_ff_head;
+        while (prev->next != block) {
+            prev = prev->next;
+        }
+
+        prev->next = block->next;
+        bench_ff_free_size += block->size;
+    });
+}
+
+/* 被测试的分配器 */
+struct bench_allocator {
+    const char *name;
+    void *(*alloc)(size_t size);
+    void (*free)(void *ptr);
+};
+
+struct bench_memory_result {
+    struct bench_stat alloc;
+    struct bench_stat free;
+    size_t failed_count;
+};
+
+/* 测量一次分配, 测量期间屏蔽中断 */
+static void *bench_memory_alloc(const struct bench_allocator *const allocator,
+                                struct bench_memory_result *const result, const size_t size) {
+    atomic_begin();
+    const uint32_t start = bench_begin();
+    void *const ptr = allocator->alloc(size);
+    const uint32_t cycles = bench_end(start);
+    atomic_end();
+
+    bench_stat_add(&result->alloc, cycles);
+    if (ptr == NULL) {
+        ++result->failed_count;
+    }
+
+    return ptr;
+}
+
+/* 测量一次释放 */
+static void bench_memory_free(const struct bench_allocator *const allocator,
+                              struct bench_memory_result *const result, void *const ptr) {
+    atomic_begin();
+    const uint32_t start = bench_begin();
+    allocator->free(ptr);
+    const uint32_t cycles = bench_end(start);
+    atomic_end();
+
+    bench_stat_add(&result->free, cycles);
+}
+
+/* 伪随机数(线性同余), 两个分配器使用相同的序列 */
+static uint32_t bench_memory_random(uint32_t *const seed) {
+    *seed = *seed * 1664525U + 1013904223U;
+    return *seed >> 8;
+}
+
+static size_t bench_memory_random_size(uint32_t *const seed) {
+    return BENCH_MEMORY_SIZE_MIN + bench_memory_random(seed) % (BENCH_MEMORY_SIZE_MAX - BENCH_MEMORY_SIZE_MIN + 1U);
+}
+
+/* 同一组操作分别在两个分配器上执行 */
+static void bench_memory_run(const struct bench_allocator *const allocator) {
+    struct bench_memory_result result = {BENCH_STAT_INITIALIZER, BENCH_STAT_INITIALIZER, 0U};
+    void *slots[BENCH_MEMORY_SLOT_NUM] = {NULL};
+    uint32_t seed = 1U;
+
+    /* 填满所有槽位, 再释放偶数槽位, 制造大量小间隙 */
+    for (size_t i = 0; i < BENCH_MEMORY_SLOT_NUM; ++i) {
+        slots[i] = bench_memory_alloc(allocator, &result, bench_memory_random_size(&seed));
+    }
+    for (size_t i = 0; i < BENCH_MEMORY_SLOT_NUM; i += 2U) {
+        bench_memory_free(allocator, &result, slots[i]);
+        slots[i] = NULL;
+    }
+
+    /* 首次适应的最坏情况: 分配放不进任何间隙的块(遍历整个链表), 再释放链表末尾的块 */
+    void *const large = bench_memory_alloc(allocator, &result, 2U * BENCH_MEMORY_SIZE_MAX);
+    bench_memory_free(allocator, &result, large);
+
+    /* 随机分配和释放 */
+    for (size_t i = 0; i < BENCH_MEMORY_CHURN; ++i) {
+        const size_t slot = bench_memory_random(&seed) % BENCH_MEMORY_SLOT_NUM;
+
+        if (slots[slot] != NULL) {
+            bench_memory_free(allocator, &result, slots[slot]);
+            slots[slot] = NULL;
+        } else {
+            slots[slot] = bench_memory_alloc(allocator, &result, bench_memory_random_size(&seed));
+        }
+    }
+
+    for (size_t i = 0; i < BENCH_MEMORY_SLOT_NUM; ++i) {
+        if (slots[i] != NULL) {
+            bench_memory_free(allocator, &result, slots[i]);
+        }
+    }
+
+    fmt_printf("%-12s %10lu %10lu %10lu %10lu %8u\r\n", allocator->name,
+               (unsigned long)result.alloc.max_cycles, bench_stat_avg(&result.alloc),
+               (unsigned long)result.free.max_cycles, bench_stat_avg(&result.free), (unsigned int)result.failed_count);
+}
+
+/* 动态内存分配性能测试 */
+void bench_memory(void) {
+    const struct bench_allocator allocators[] = {
+        {"tlsf", memory_alloc, memory_free},
+        {"first-fit", bench_ff_alloc, bench_ff_free},
+    };
+
+    bench_ff_init();
+
+    fmt_printf("memory: %d slots, %u-%u bytes, %d operations (cycles)\r\n", BENCH_MEMORY_SLOT_NUM,
+               BENCH_MEMORY_SIZE_MIN, BENCH_MEMORY_SIZE_MAX, BENCH_MEMORY_CHURN);
+    fmt_printf("%-12s %10s %10s %10s %10s %8s\r\n", "allocator", "alloc max", "alloc avg", "free max", "free avg",
+               "failed");
+
+    for (size_t i = 0; i < sizeof(allocators) / sizeof(allocators[0]); ++i) {
+        bench_memory_run(&allocators[i]);
+    }
+}
@@ -0,0 +1,99 @@
+#include "bench.h"
+#include <utility/fmt.h>
+#include <utility/pid_controller.h>
+#include <utility/pid_fixed.h>
+#include <zhiyec/atomic.h>
+
+/* 测试参数 */
+#define BENCH_PID_STEPS 1000     // 控制周期数
+#define BENCH_PID_KP 2.0f
+#define BENCH_PID_KI 20.0f
+#define BENCH_PID_KD 0.01f
+#define BENCH_PID_DT 0.001f      // 采样周期, 单位: 秒
+#define BENCH_PID_PLANT_GAIN 0.05f // 被控对象(一阶惯性)每周期的响应比例
+
+/* 设定值: 每1/4个测试周期在正负之间阶跃, 使两个控制器都经历饱和和积分修正 */
+static float bench_pid_setpoint(const int step) {
+    return ((step / (BENCH_PID_STEPS / 4)) & 1) ? -0.5f : 0.5f;
+}
+
+static void bench_pid_print(const char *const name, const struct bench_stat *const stat) {
+    fmt_printf("%-10s %10lu %10lu\r\n", name, (unsigned long)stat->max_cycles, bench_stat_avg(stat));
+}
+
+/* 浮点PID, 输入输出范围[-1, 1] */
+static void bench_pid_float(void) {
+    uint32_t pid_mem[(PIDCONTROLLER_BYTE + sizeof(uint32_t) - 1U) / sizeof(uint32_t)];
+    struct pid_controller *const pid = pid_controller_init(pid_mem, BENCH_PID_KP, BENCH_PID_KI, BENCH_PID_KD);
+    struct bench_stat stat = BENCH_STAT_INITIALIZER;
+    float measurement = 0.0f;
+
+    for (int step = 0; step < BENCH_PID_STEPS; ++step) {
+        const float error = pid_controller_cal_error(bench_pid_setpoint(step), measurement);
+
+        atomic_begin();
+        const uint32_t start = bench_begin();
+        float output = pid_controller_cal_output(pid, error, BENCH_PID_DT);
+        const uint32_t cycles = bench_end(start);
+        atomic_end();
+
+        bench_stat_add(&stat, cycles);
+
+        /* pid_controller 没有输出限幅, 由被控对象限幅 */
+        if (output > 1.0f) {
+            output = 1.0f;
+        } else if (output < -1.0f) {
+            output = -1.0f;
+        }
+        measurement += (output - measurement) * BENCH_PID_PLANT_GAIN;
+    }
+
+    bench_pid_print("float", &stat);
+}
+
+/* 定点PID, 输入输出为Q15 */
+static void bench_pid_fixed(const char *const name, const enum pid_fixed_antiwindup antiwindup) {
+    uint32_t pid_mem[(PIDFIXED_BYTE + sizeof(uint32_t) - 1U) / sizeof(uint32_t)];
+    const struct pid_fixed_config config = {
+        .kp = BENCH_PID_KP,
+        .ki = BENCH_PID_KI,
+        .kd = BENCH_PID_KD,
+        .dt = BENCH_PID_DT,
+        .tf = 0.0f,
+        .output_min = PIDFIXED_Q15(-1.0),
+        .output_max = PIDFIXED_Q15(1.0),
+        .antiwindup = antiwindup,
+        .tt = 0.01f,
+    };
+    struct pid_fixed *const pid = pid_fixed_init(pid_mem, &config);
+    struct bench_stat stat = BENCH_STAT_INITIALIZER;
+    int16_t measurement = 0;
+
+    pid_fixed_reset(pid, measurement);
+
+    for (int step = 0; step < BENCH_PID_STEPS; ++step) {
+        const int16_t setpoint = PIDFIXED_Q15(bench_pid_setpoint(step));
+
+        atomic_begin();
+        const uint32_t start = bench_begin();
+        const int16_t output = pid_fixed_cal_output(pid, setpoint, measurement);
+        const uint32_t cycles = bench_end(start);
+        atomic_end();
+
+        bench_stat_add(&stat, cycles);
+
+        measurement += (int16_t)((output - measurement) * BENCH_PID_PLANT_GAIN);
+    }
+
+    bench_pid_print(name, &stat);
+}
+
+/* PID控制器性能测试 */
+void bench_pid(void) {
+    fmt_printf("pid: %d steps (cycles)\r\n", BENCH_PID_STEPS);
+    fmt_printf("%-10s %10s %10s\r\n", "controller", "max", "avg");
+
+    bench_pid_float();
+    bench_pid_fixed("fixed", PIDFIXED_ANTIWINDUP_CLAMP);
+    bench_pid_fixed("fixed-bc", PIDFIXED_ANTIWINDUP_BACK_CALCULATION);
+}
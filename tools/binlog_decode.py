@@ -0,0 +1,129 @@
+#!/usr/bin/env python3
+"""
+@file binlog_decode.py
+@author Zhiyelah
+@brief 二进制日志解码工具
+@note 从固件ELF文件的 .binlog 段中读取格式字符串, 将 binlog_flush 输出的记录还原为文本.
+      记录格式见 include/utility/binlog.h
+
+用法: binlog_decode.py firmware.elf capture.bin [--tick-hz 1000]
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MARKER = 0xB10C0000
+MARKER_MASK = 0xFFFF0000
+ARGS_MAX = 8
+
+SPEC = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|l|z)?([diuxXcspfF%])')
+
+
+def read_binlog_section(path):
+    """最小的ELF解析: 只读取节头表, 返回 .binlog 段的 (地址, 内容)"""
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    if data[:4] != b'\x7fELF':
+        sys.exit(f'{path}: not an ELF file')
+
+    is_64 = data[4] == 2
+    endian = '<' if data[5] == 1 else '>'
+
+    if is_64:
+        shoff, = struct.unpack_from(endian + 'Q', data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x3A)
+        header = endian + 'IIQQQQIIQQ'
+    else:
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', data, 0x2E)
+        header = endian + 'IIIIIIIIII'
+
+    sections = [struct.unpack_from(header, data, shoff + i * shentsize) for i in range(shnum)]
+    strtab = sections[shstrndx]
+    names = data[strtab[4]:strtab[4] + strtab[5]]
+
+    for name, _type, _flags, addr, offset, size, *_ in sections:
+        if names[name:names.index(b'\0', name)] == b'.binlog':
+            return addr, data[offset:offset + size]
+
+    sys.exit(f'{path}: no .binlog section')
+
+
+def format_message(fmt, args):
+    """按printf格式还原文本, 每个参数为一个32位字"""
+    args = list(args)
+
+    def take():
+        return args.pop(0) if args else 0
+
+    def convert(m):
+        flags, width, precision, _length, conv = m.groups()
+        if conv == '%':
+            return '%'
+        if width == '*':
+            width = str(struct.unpack('<i', struct.pack('<I', take()))[0])
+        if precision == '*':
+            precision = str(take())
+
+        word = take()
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+
+        if conv in 'di':
+            return (spec + 'd') % struct.unpack('<i', struct.pack('<I', word))[0]
+        if conv in 'fF':
+            return (spec + 'f') % struct.unpack('<f', struct.pack('<I', word))[0]
+        if conv == 'c':
+            return (spec + 'c') % chr(word & 0xFF)
+        if conv == 'p':
+            return (spec.replace('#', '') + 's') % f'0x{word:08x}'
+        if conv == 's':
+            return (spec + 's') % f'<str@0x{word:08x}>'
+        return (spec + conv) % word
+
+    return SPEC.sub(convert, fmt)
+
+
+def decode(stream, base, strings, tick_hz):
+    pos = 0
+    while pos + 12 <= len(stream):
+        header, = struct.unpack_from('<I', stream, pos)
+        nargs = header & ~MARKER_MASK & 0xFFFFFFFF
+        if (header & MARKER_MASK) != MARKER or nargs > ARGS_MAX:
+            # 失去同步, 逐字节查找下一个记录头
+            pos += 1
+            continue
+
+        length = (3 + nargs) * 4
+        if pos + length > len(stream):
+            break
+
+        fmt_addr, timestamp, *args = struct.unpack_from(f'<{2 + nargs}I', stream, pos + 4)
+        pos += length
+
+        offset = fmt_addr - base
+        if not 0 <= offset < len(strings):
+            print(f'[{timestamp}] <unknown format 0x{fmt_addr:08x}> {args}')
+            continue
+        fmt = strings[offset:strings.index(b'\0', offset)].decode('utf-8', 'replace')
+
+        stamp = f'{timestamp / tick_hz:10.3f}' if tick_hz else f'{timestamp:10d}'
+        print(f'[{stamp}] {format_message(fmt, args)}')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='decode binlog records')
+    parser.add_argument('elf', help='firmware ELF containing the .binlog section')
+    parser.add_argument('capture', help='raw bytes captured from the binlog stream')
+    parser.add_argument('--tick-hz', type=int, default=0, help='print timestamps in seconds')
+    args = parser.parse_args()
+
+    base, strings = read_binlog_section(args.elf)
+    with open(args.capture, 'rb') as f:
+        decode(f.read(), base, strings, args.tick_hz)
+
+
+if __name__ == '__main__':
+    main()
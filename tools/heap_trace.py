@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""
+@file heap_trace.py
+@author Zhiyelah
+@brief 内存分配跟踪分析工具
+@note 输入为 memory_trace_copy 导出的记录, 每行一条: "时间戳 调用者 指针 大小"(地址为十六进制),
+      大小为0表示释放, 指针为0表示分配失败; 控制台命令 heaptrace 按该格式输出记录.
+      输出占用内存时间线与按调用者汇总的泄漏报告.
+      指定堆区域(--region 起始地址:大小, 内存池地址见map文件中的 memory_pool)时, 按TLSF的块布局
+      (块头 + 按对齐取整的数据)在区域中重放分配和释放, 时间线中增加最大空闲块与空闲块(碎片)数量;
+      记录只覆盖跟踪窗口, 窗口之前的分配无法重放, 此时碎片数据只反映窗口内的分配.
+
+用法: heap_trace.py trace.txt [--region 0x20000100:4096 ...] [--header 8] [--align 8]
+                    [--elf firmware.elf] [--addr2line arm-none-eabi-addr2line]
+"""
+
+import argparse
+import subprocess
+import sys
+from collections import defaultdict
+
+
+def parse(lines):
+    records = []
+    for line_no, line in enumerate(lines, 1):
+        line = line.split('#', 1)[0].strip()
+        if not line:
+            continue
+        fields = line.split()
+        if len(fields) != 4:
+            sys.exit(f'line {line_no}: expected "tick caller ptr size", got: {line}')
+        tick, caller, ptr, size = fields
+        records.append((int(tick, 0), int(caller, 16), int(ptr, 16), int(size, 0)))
+    return records
+
+
+def resolve(addrs, elf, addr2line):
+    names = {addr: f'0x{addr:08x}' for addr in addrs}
+    if not elf or not addrs:
+        return names
+    try:
+        out = subprocess.run([addr2line, '-f', '-s', '-e', elf] + [hex(a) for a in addrs],
+                             capture_output=True, text=True, check=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError) as e:
+        print(f'warning: addr2line failed: {e}', file=sys.stderr)
+        return names
+    for addr, func, loc in zip(addrs, out[0::2], out[1::2]):
+        names[addr] = f'0x{addr:08x} {func} ({loc})'
+    return names
+
+
+def parse_region(text):
+    try:
+        base, size = text.split(':')
+        return int(base, 16), int(size, 0)
+    except ValueError:
+        raise argparse.ArgumentTypeError(f'expected BASE:SIZE, got: {text}')
+
+
+class HeapReplay:
+    """按TLSF的块布局重放分配, 统计各区域的空闲块"""
+
+    def __init__(self, regions, header, align):
+        self.header = header
+        self.align = align
+        self.regions = []
+        for base, size in regions:
+            start = (base + align - 1) & ~(align - 1)
+            end = (base + size) & ~(align - 1)
+            # 末尾的哨兵块头不可分配
+            self.regions.append((start, end - header))
+        self.blocks = {}        # ptr -> (block start, block end)
+
+    def _region_of(self, addr):
+        for start, end in self.regions:
+            if start <= addr < end:
+                return start, end
+        return None
+
+    def alloc(self, ptr, size):
+        size = max(size, self.header)
+        size = (size + self.align - 1) & ~(self.align - 1)
+        if self._region_of(ptr) is None:
+            return False
+        self.blocks[ptr] = (ptr - self.header, ptr + size)
+        return True
+
+    def free(self, ptr):
+        return self.blocks.pop(ptr, None) is not None
+
+    def fragmentation(self):
+        """返回 (最大空闲块大小, 空闲块数量), 大小不含块头"""
+        largest = 0
+        holes = 0
+        for start, end in self.regions:
+            used = sorted(b for b in self.blocks.values() if start <= b[0] < end)
+            pos = start
+            for block_start, block_end in used + [(end, end)]:
+                gap = block_start - pos
+                # 容纳不下块头和最小块的间隙是分配时未分割的剩余部分
+                if gap >= 2 * self.header:
+                    holes += 1
+                    largest = max(largest, gap - self.header)
+                pos = max(pos, block_end)
+        return largest, holes
+
+
+def main():
+    parser = argparse.ArgumentParser(description='heap trace timeline and leak report')
+    parser.add_argument('trace', type=argparse.FileType('r'))
+    parser.add_argument('--elf', help='firmware ELF used to resolve caller addresses')
+    parser.add_argument('--addr2line', default='arm-none-eabi-addr2line')
+    parser.add_argument('--region', type=parse_region, action='append', default=[],
+                        help='heap region BASE:SIZE, repeat for each region, enables fragmentation columns')
+    parser.add_argument('--header', type=int, default=8, help='TLSF block header size')
+    parser.add_argument('--align', type=int, default=8, help='allocation alignment (BYTE_ALIGNMENT)')
+    args = parser.parse_args()
+
+    records = parse(args.trace)
+    replay = HeapReplay(args.region, args.header, args.align) if args.region else None
+    untracked = 0
+    min_largest = None
+    max_holes = 0
+
+    live = {}                  # ptr -> (size, caller, tick)
+    live_bytes = 0
+    peak_bytes = 0
+    failures = defaultdict(int)
+
+    header = 'tick        live_bytes  live_blocks  '
+    if replay:
+        header += 'largest_free  holes  '
+    print(header + 'event')
+    for tick, caller, ptr, size in records:
+        if size == 0:
+            if ptr in live:
+                live_bytes -= live.pop(ptr)[0]
+                event = f'free  0x{ptr:08x}'
+            else:
+                # 分配发生在记录窗口之前
+                untracked += 1
+                event = f'free  0x{ptr:08x} (untracked)'
+            if replay:
+                replay.free(ptr)
+        elif ptr == 0:
+            failures[caller] += 1
+            event = f'FAIL  {size} bytes'
+        else:
+            live[ptr] = (size, caller, tick)
+            live_bytes += size
+            event = f'alloc 0x{ptr:08x} {size} bytes'
+            if replay and not replay.alloc(ptr, size):
+                event += ' (outside regions)'
+        peak_bytes = max(peak_bytes, live_bytes)
+        line = f'{tick:<11} {live_bytes:<11} {len(live):<12} '
+        if replay:
+            largest, holes = replay.fragmentation()
+            min_largest = largest if min_largest is None else min(min_largest, largest)
+            max_holes = max(max_holes, holes)
+            line += f'{largest:<13} {holes:<6} '
+        print(line + event)
+
+    print(f'\npeak live bytes in window: {peak_bytes}')
+    if replay and min_largest is not None:
+        print(f'smallest largest free block: {min_largest}')
+        print(f'most free blocks (holes): {max_holes}')
+        if untracked:
+            print(f'note: {untracked} blocks were allocated before the window and are missing from the replay')
+
+    leaks = defaultdict(lambda: [0, 0, None])   # caller -> [blocks, bytes, oldest tick]
+    for size, caller, tick in live.values():
+        entry = leaks[caller]
+        entry[0] += 1
+        entry[1] += size
+        entry[2] = tick if entry[2] is None else min(entry[2], tick)
+
+    names = resolve(sorted(set(leaks) | set(failures)), args.elf, args.addr2line)
+
+    print('\noutstanding allocations by caller (possible leaks):')
+    if not leaks:
+        print('  none')
+    for caller, (blocks, nbytes, oldest) in sorted(leaks.items(), key=lambda kv: -kv[1][1]):
+        print(f'  {nbytes:>8} bytes in {blocks:>4} blocks, oldest at tick {oldest}: {names[caller]}')
+
+    if failures:
+        print('\nfailed allocations by caller:')
+        for caller, count in sorted(failures.items(), key=lambda kv: -kv[1]):
+            print(f'  {count:>8} times: {names[caller]}')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,180 @@
+#include <asm/exclusive.h>
+#include <asm/irq.h>
+#include <utility/binlog.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/compiler.h>
+#include <zhiyec/tick.h>
+
+/* 时间戳 */
+#define binlog_timestamp() ((uint32_t)tick_get_current())
+
+struct binlog_buffer {
+    volatile uint32_t *buffer;
+    /* 缓冲区大小掩码(单位: 字) */
+    uint32_t mask;
+    /* 已预留的位置(自由增长, 取模后为下标) */
+    volatile uint32_t head;
+    /* 已发送的位置 */
+    volatile uint32_t tail;
+    /* 丢弃的日志数量 */
+    volatile uint32_t dropped_count;
+};
+
+static struct binlog_buffer binlog = {.buffer = NULL};
+
+void binlog_init(uint32_t *const buffer, const size_t word_count) {
+    assert(buffer != NULL);
+    /* 缓冲区大小必须是2的幂 */
+    assert(word_count != 0U && (word_count & (word_count - 1U)) == 0U);
+
+    for (size_t i = 0; i < word_count; ++i) {
+        buffer[i] = 0U;
+    }
+
+    binlog.mask = (uint32_t)word_count - 1U;
+    binlog.head = 0U;
+    binlog.tail = 0U;
+    binlog.dropped_count = 0U;
+    binlog.buffer = buffer;
+}
+
+#if (ARCH_HAS_EXCLUSIVE_ACCESS)
+
+/* 无锁地预留空间, 返回起始位置 */
+static inline bool binlog_reserve(const uint32_t length, uint32_t *const pos) {
+    uint32_t head;
+
+    do {
+        head = exclusive_load(&binlog.head);
+
+        if (binlog.mask + 1U - (head - binlog.tail) < length) {
+            exclusive_clear();
+            return false;
+        }
+    } while (!exclusive_store(&binlog.head, head + length));
+
+    *pos = head;
+    return true;
+}
+
+static inline void binlog_count_dropped(void) {
+    uint32_t value;
+
+    do {
+        value = exclusive_load(&binlog.dropped_count) + 1U;
+    } while (!exclusive_store(&binlog.dropped_count, value));
+}
+
+#else
+
+/* 不支持独占访问的架构(Cortex-M0)以短暂屏蔽中断代替 */
+
+static inline bool binlog_reserve(const uint32_t length, uint32_t *const pos) {
+    bool is_reserved = false;
+
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    const uint32_t head = binlog.head;
+    if (binlog.mask + 1U - (head - binlog.tail) >= length) {
+        binlog.head = head + length;
+        *pos = head;
+        is_reserved = true;
+    }
+
+    irq_enable_from_isr(prev_basepri);
+
+    return is_reserved;
+}
+
+static inline void binlog_count_dropped(void) {
+    uint32_t prev_basepri = irq_disable_from_isr();
+    ++binlog.dropped_count;
+    irq_enable_from_isr(prev_basepri);
+}
+
+#endif /* ARCH_HAS_EXCLUSIVE_ACCESS */
+
+/* 写入日志记录 */
+bool binlog_write(const char *const format, const uint32_t nargs, const uint32_t *const args) {
+    assert(nargs <= BINLOG_ARGS_MAX);
+
+    if (binlog.buffer == NULL) {
+        return false;
+    }
+
+    const uint32_t timestamp = binlog_timestamp();
+    uint32_t pos;
+
+    if (!binlog_reserve(BINLOG_RECORD_WORDS(nargs), &pos)) {
+        binlog_count_dropped();
+        return false;
+    }
+
+    volatile uint32_t *const buffer = binlog.buffer;
+    const uint32_t mask = binlog.mask;
+
+    buffer[(pos + 1U) & mask] = (uint32_t)(uintptr_t)format;
+    buffer[(pos + 2U) & mask] = timestamp;
+    for (uint32_t i = 0; i < nargs; ++i) {
+        buffer[(pos + 3U + i) & mask] = args[i];
+    }
+
+    /* 记录头最后写入, 之后记录对发送者可见 */
+    DMB();
+    buffer[pos & mask] = BINLOG_MARKER | nargs;
+
+    return true;
+}
+
+/* 发送已写完的日志记录 */
+void binlog_flush(const struct PrintStream *const stream) {
+    assert(stream != NULL);
+
+    if (binlog.buffer == NULL) {
+        return;
+    }
+
+    volatile uint32_t *const buffer = binlog.buffer;
+    const uint32_t mask = binlog.mask;
+    byte record[BINLOG_RECORD_WORDS(BINLOG_ARGS_MAX) * 4U];
+
+    while (binlog.tail != binlog.head) {
+        const uint32_t tail = binlog.tail;
+        const uint32_t header = buffer[tail & mask];
+
+        /* 记录尚未写完, 之后的记录需等待它写完再发送以保持顺序 */
+        if ((header & BINLOG_MARKER_MASK) != BINLOG_MARKER) {
+            break;
+        }
+
+        DMB();
+
+        const uint32_t length = BINLOG_RECORD_WORDS(header & ~BINLOG_MARKER_MASK);
+
+        /* 按小端字节序复制, 复制后清零, 避免旧数据在下一轮被误认为记录头 */
+        for (uint32_t i = 0; i < length; ++i) {
+            const uint32_t word = buffer[(tail + i) & mask];
+            buffer[(tail + i) & mask] = 0U;
+
+            record[i * 4U + 0U] = (byte)(word);
+            record[i * 4U + 1U] = (byte)(word >> 8);
+            record[i * 4U + 2U] = (byte)(word >> 16);
+            record[i * 4U + 3U] = (byte)(word >> 24);
+        }
+
+        DMB();
+        binlog.tail = tail + length;
+
+        if (stream->write_block != NULL) {
+            stream->write_block((const char *)record, length * 4U);
+        } else {
+            for (uint32_t i = 0; i < length * 4U; ++i) {
+                stream->write((char)record[i]);
+            }
+        }
+    }
+}
+
+size_t binlog_get_dropped(void) {
+    return binlog.dropped_count;
+}
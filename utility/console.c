@@ -1,8 +1,14 @@
+#include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
 #include <utility/console.h>
+#include <zhiyec/event_flags.h>
+#include <zhiyec/kernel.h>
 
 /* 控制台配置参数 */
-#define COMMAND_LIST_SIZE 10     // 已注册命令列表大小
+#define COMMAND_LIST_SIZE 10     // 运行时注册命令列表大小
+#define COMMAND_HASH_SIZE 64     // 命令哈希表大小(必须是2的幂)
+#define INPUT_RING_SIZE 64       // 中断输入缓冲区大小(必须是2的幂)
 #define INPUT_BUFFER_SIZE 128    // 输入缓冲区大小
 #define COMMAND_MAX_ARGS 8       // 最大参数数量
 #define PROMPT_STRING "zhiyec> " // 命令提示符
@@ -11,39 +17,112 @@
 /* 控制台输出 */
 #define console_printf(...) fmt_printf(__VA_ARGS__)
 
+/* 静态注册的命令所在的段 */
+#if defined(__ARMCC_VERSION)
+extern const struct console_cmd console_cmd$$Base[];
+extern const struct console_cmd console_cmd$$Limit[];
+#define static_commands_begin (console_cmd$$Base)
+#define static_commands_end (console_cmd$$Limit)
+#else
+extern const struct console_cmd __start_console_cmd[];
+extern const struct console_cmd __stop_console_cmd[];
+#define static_commands_begin (__start_console_cmd)
+#define static_commands_end (__stop_console_cmd)
+#endif
+
+/* 中断输入缓冲区(单生产者单消费者, 无锁) */
+static volatile char input_ring[INPUT_RING_SIZE];
+static volatile size_t input_ring_head = 0U;
+static volatile size_t input_ring_tail = 0U;
+
+/* 有字符输入时通知控制台任务 */
+#define CONSOLE_EVENT_INPUT 0x01U
+static struct eventflags *console_events = ALLOCATE_STACK(EVENTFLAGS_BYTE);
+
 /* 输入缓存区 */
 static char input_buffer[INPUT_BUFFER_SIZE];
 static size_t input_len = 0U;
 
+/* 命令哈希表(开放寻址) */
+static const struct console_cmd *command_table[COMMAND_HASH_SIZE];
+static bool command_table_is_init = false;
+/* 哈希表已满, 未放入的静态命令需逐个查找 */
+static bool command_table_is_full = false;
+
+/* 运行时注册的命令列表 */
+static const struct console_cmd *commands[COMMAND_LIST_SIZE];
+static size_t command_count = 0U;
+
 static int console_builtin_cmd_cmd_handler(int argc, char *argv[]);
 static int console_builtin_cmd_help_handler(int argc, char *argv[]);
 static int console_builtin_cmd_version_handler(int argc, char *argv[]);
 
-static const struct console_cmd console_builtin_cmd_cmd = {
-    .name = "cmd",
-    .description = "Start console",
-    .handler = console_builtin_cmd_cmd_handler,
-};
-
-static const struct console_cmd console_builtin_cmd_help = {
-    .name = "help",
-    .description = "Show available commands",
-    .handler = console_builtin_cmd_help_handler,
-};
-
-static const struct console_cmd console_builtin_cmd_version = {
-    .name = "version",
-    .description = "Show console version",
-    .handler = console_builtin_cmd_version_handler,
-};
-
-/* 已注册命令列表 */
-static const struct console_cmd *commands[COMMAND_LIST_SIZE] = {
-    &console_builtin_cmd_cmd,
-    &console_builtin_cmd_help,
-    &console_builtin_cmd_version,
-};
-static size_t command_count = 3U;
+CONSOLE_CMD_REGISTER("cmd", "Start console", console_builtin_cmd_cmd_handler);
+CONSOLE_CMD_REGISTER("help", "Show available commands", console_builtin_cmd_help_handler);
+CONSOLE_CMD_REGISTER("version", "Show console version", console_builtin_cmd_version_handler);
+
+/* 字符串哈希(djb2) */
+static uint32_t command_hash(const char *str) {
+    uint32_t hash = 5381U;
+
+    while (*str != '\0') {
+        hash = hash * 33U + (uint8_t)*str++;
+    }
+
+    return hash;
+}
+
+/* 将命令放入哈希表, 返回是否成功 */
+static bool command_table_insert(const struct console_cmd *const cmd) {
+    uint32_t index = command_hash(cmd->name) & (COMMAND_HASH_SIZE - 1U);
+
+    for (size_t i = 0; i < COMMAND_HASH_SIZE; ++i) {
+        if (command_table[index] == NULL) {
+            command_table[index] = cmd;
+            return true;
+        }
+        index = (index + 1U) & (COMMAND_HASH_SIZE - 1U);
+    }
+
+    return false;
+}
+
+/* 建立命令哈希表 */
+static void command_table_init(void) {
+    for (const struct console_cmd *cmd = static_commands_begin; cmd < static_commands_end; ++cmd) {
+        if (!command_table_insert(cmd)) {
+            command_table_is_full = true;
+        }
+    }
+
+    command_table_is_init = true;
+}
+
+/* 查找命令 */
+static const struct console_cmd *command_find(const char *const name) {
+    if (!command_table_is_init) {
+        command_table_init();
+    }
+
+    uint32_t index = command_hash(name) & (COMMAND_HASH_SIZE - 1U);
+
+    for (size_t i = 0; i < COMMAND_HASH_SIZE && command_table[index] != NULL; ++i) {
+        if (strcmp(name, command_table[index]->name) == 0) {
+            return command_table[index];
+        }
+        index = (index + 1U) & (COMMAND_HASH_SIZE - 1U);
+    }
+
+    if (command_table_is_full) {
+        for (const struct console_cmd *cmd = static_commands_begin; cmd < static_commands_end; ++cmd) {
+            if (strcmp(name, cmd->name) == 0) {
+                return cmd;
+            }
+        }
+    }
+
+    return NULL;
+}
 
 /* 处理输入缓冲区中的命令 */
 static inline void handle_input_buffer(void) {
@@ -63,17 +142,60 @@ static inline void handle_input_buffer(void) {
     }
 
     /* 查找并执行对应的命令 */
-    for (size_t i = 0; i < command_count; ++i) {
-        if (strcmp(argv[0], commands[i]->name) == 0) {
-            commands[i]->handler(argc, argv);
-            return;
-        }
+    const struct console_cmd *const cmd = command_find(argv[0]);
+    if (cmd != NULL) {
+        cmd->handler(argc, argv);
+        return;
     }
 
     console_printf("Unknown command: %s\r\n", argv[0]);
     console_printf("Type 'help' for command list\r\n");
 }
 
+/* 初始化控制台 */
+void console_init(void) {
+    eventflags_init(console_events, 0U);
+
+    if (!command_table_is_init) {
+        command_table_init();
+    }
+}
+
+/* 控制台任务 */
+void console_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        eventflags_wait(console_events, CONSOLE_EVENT_INPUT, EVENTFLAGS_CLEAR_ON_EXIT);
+
+        /* 处理所有已输入的字符 */
+        while (input_ring_tail != input_ring_head) {
+            const size_t tail = input_ring_tail;
+            const char ch = input_ring[tail];
+
+            input_ring_tail = (tail + 1U) & (INPUT_RING_SIZE - 1U);
+
+            console_input_char(ch);
+        }
+    }
+}
+
+/* 中断中输入字符 */
+void console_input_char_from_isr(char ch) {
+    const size_t head = input_ring_head;
+    const size_t next_head = (head + 1U) & (INPUT_RING_SIZE - 1U);
+
+    /* 缓冲区满, 丢弃字符 */
+    if (next_head == input_ring_tail) {
+        return;
+    }
+
+    input_ring[head] = ch;
+    input_ring_head = next_head;
+
+    eventflags_set_from_isr(console_events, CONSOLE_EVENT_INPUT);
+}
+
 /* 输入字符 */
 void console_input_char(char ch) {
     if (ch == '\r') { /* 回车 */
@@ -109,7 +231,11 @@ void console_input_char(char ch) {
 
 /* 注册命令 */
 void console_register_cmd(const struct console_cmd *const cmd) {
-    if (command_count < COMMAND_LIST_SIZE) {
+    if (!command_table_is_init) {
+        command_table_init();
+    }
+
+    if (command_count < COMMAND_LIST_SIZE && command_table_insert(cmd)) {
         commands[command_count++] = cmd;
     } else {
         console_printf("Command list full, cannot register %s\r\n", cmd->name);
@@ -128,6 +254,9 @@ static int console_builtin_cmd_cmd_handler(int argc, char *argv[]) {
 /* 帮助命令 */
 static int console_builtin_cmd_help_handler(int argc, char *argv[]) {
     console_printf("Available commands:\r\n");
+    for (const struct console_cmd *cmd = static_commands_begin; cmd < static_commands_end; ++cmd) {
+        console_printf("  %-10s %s\r\n", cmd->name, cmd->description);
+    }
     for (size_t i = 0; i < command_count; ++i) {
         console_printf("  %-10s %s\r\n", commands[i]->name, commands[i]->description);
     }
@@ -136,6 +265,6 @@ static int console_builtin_cmd_help_handler(int argc, char *argv[]) {
 
 /* 版本命令 */
 static int console_builtin_cmd_version_handler(int argc, char *argv[]) {
-    console_printf("ZhiyecRTOS Console v1.2\r\n");
+    console_printf("ZhiyecRTOS Console v1.3\r\n");
     return 0;
 }
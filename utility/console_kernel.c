@@ -0,0 +1,229 @@
+#include <config.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utility/console.h>
+#include <utility/fmt.h>
+#include <zhiyec/kobject.h>
+#include <zhiyec/task.h>
+#include <zhiyec/tick.h>
+
+#if (!USE_KERNEL_INTROSPECTION)
+#error please set USE_KERNEL_INTROSPECTION to 1 or remove this file from your project.
+#endif
+
+#if (USE_DYNAMIC_MEMORY_ALLOCATION)
+#include <zhiyec/memory.h>
+#endif
+
+/* 本文件中的命令只通过 console_cmd 段访问, 链接时需保留该段, 见 CONSOLE_CMD_REGISTER */
+
+/* 内核信息命令配置参数 */
+#define TASK_SNAPSHOT_MAX (CONFIG_TASK_MAX_NUM)              // 最多显示的任务数量
+#define KOBJECT_SNAPSHOT_MAX 16                              // 最多显示的内核对象数量
+#define TOP_DEFAULT_INTERVAL_MS 1000                         // top命令默认的统计时长
+#define HEAPTRACE_SNAPSHOT_MAX (CONFIG_MEMORY_TRACE_DEPTH)   // 最多显示的内存分配跟踪记录数量
+
+/* 控制台输出 */
+#define console_printf(...) fmt_printf(__VA_ARGS__)
+
+/* 快照缓冲区, 只在控制台任务中使用, 不占用任务栈 */
+static struct task_snapshot task_snapshots[TASK_SNAPSHOT_MAX];
+static struct kobject_info kobject_infos[KOBJECT_SNAPSHOT_MAX];
+
+/* top命令的起始运行时间 */
+static const struct task_struct *top_tasks[TASK_SNAPSHOT_MAX];
+static tick_t top_run_ticks[TASK_SNAPSHOT_MAX];
+
+#if (USE_DYNAMIC_MEMORY_ALLOCATION && USE_MEMORY_TRACE)
+static struct memory_trace_record heaptrace_records[HEAPTRACE_SNAPSHOT_MAX];
+#endif
+
+static int console_kernel_cmd_ps_handler(int argc, char *argv[]);
+static int console_kernel_cmd_top_handler(int argc, char *argv[]);
+static int console_kernel_cmd_heap_handler(int argc, char *argv[]);
+static int console_kernel_cmd_heaptrace_handler(int argc, char *argv[]);
+static int console_kernel_cmd_queues_handler(int argc, char *argv[]);
+
+CONSOLE_CMD_REGISTER("ps", "Show tasks", console_kernel_cmd_ps_handler);
+CONSOLE_CMD_REGISTER("top", "Show CPU usage, usage: top [ms]", console_kernel_cmd_top_handler);
+CONSOLE_CMD_REGISTER("heap", "Show heap statistics", console_kernel_cmd_heap_handler);
+CONSOLE_CMD_REGISTER("heaptrace", "Dump heap trace for tools/heap_trace.py", console_kernel_cmd_heaptrace_handler);
+CONSOLE_CMD_REGISTER("queues", "Show kernel objects", console_kernel_cmd_queues_handler);
+
+static const char *task_state_name(const enum task_state state) {
+    switch (state) {
+    case TASKSTATE_READY:
+        return "ready";
+    case TASKSTATE_RUNNING:
+        return "running";
+    case TASKSTATE_SLEEPING:
+        return "sleep";
+    case TASKSTATE_BLOCKED:
+        return "blocked";
+    case TASKSTATE_DELETED:
+        return "deleted";
+    default:
+        return "?";
+    }
+}
+
+static const char *task_name(const struct task_snapshot *const snapshot) {
+    return (snapshot->name != NULL) ? snapshot->name : "-";
+}
+
+/* 任务列表 */
+static int console_kernel_cmd_ps_handler(int argc, char *argv[]) {
+    struct task_sched_snapshot sched;
+
+    const size_t count = task_get_snapshot(task_snapshots, TASK_SNAPSHOT_MAX);
+    task_get_sched_snapshot(&sched);
+
+    console_printf("tick %lu, %zu tasks, ready bitmap 0x%02lx, %zu sleeping\r\n",
+                   (unsigned long)sched.ticks, sched.task_count, (unsigned long)sched.ready_bitmap,
+                   sched.sleeping_count);
+    console_printf("  %-12s %4s %4s %-8s %10s %11s\r\n", "NAME", "PRIO", "SCHD", "STATE", "WAKE", "STACK");
+
+    for (size_t i = 0; i < count; ++i) {
+        const struct task_snapshot *const snapshot = &task_snapshots[i];
+
+        console_printf("  %-12s %4u %4s %-8s ", task_name(snapshot), (unsigned int)snapshot->priority,
+                       (snapshot->sched_method == TASKSCHED_FIFO) ? "fifo" : "rr",
+                       task_state_name(snapshot->state));
+
+        if (snapshot->state == TASKSTATE_SLEEPING) {
+            console_printf("%10lu ", (unsigned long)snapshot->resume_time);
+        } else {
+            console_printf("%10s ", "-");
+        }
+
+        /* 栈用量(单位: 字(word)): 历史最大用量/总大小 */
+        console_printf("%5zu/%-5zu\r\n", snapshot->stack_size - snapshot->stack_unused, snapshot->stack_size);
+    }
+
+    return 0;
+}
+
+/* CPU占用率 */
+static int console_kernel_cmd_top_handler(int argc, char *argv[]) {
+    struct task_sched_snapshot sched_begin;
+    struct task_sched_snapshot sched_end;
+
+    unsigned long interval_ms = TOP_DEFAULT_INTERVAL_MS;
+    if (argc > 1) {
+        interval_ms = strtoul(argv[1], NULL, 10);
+        if (interval_ms == 0U) {
+            console_printf("Invalid interval: %s\r\n", argv[1]);
+            return -1;
+        }
+    }
+
+    /* 记录起始运行时间 */
+    size_t begin_count = task_get_snapshot(task_snapshots, TASK_SNAPSHOT_MAX);
+    task_get_sched_snapshot(&sched_begin);
+
+    for (size_t i = 0; i < begin_count; ++i) {
+        top_tasks[i] = task_snapshots[i].task;
+        top_run_ticks[i] = task_snapshots[i].run_ticks;
+    }
+
+    task_sleep(tick_from_msec(interval_ms));
+
+    const size_t count = task_get_snapshot(task_snapshots, TASK_SNAPSHOT_MAX);
+    task_get_sched_snapshot(&sched_end);
+
+    const tick_t elapsed = sched_end.ticks - sched_begin.ticks;
+    if (elapsed == 0U) {
+        return 0;
+    }
+
+    console_printf("  %-12s %8s %7s\r\n", "NAME", "TICKS", "CPU");
+
+    for (size_t i = 0; i < count; ++i) {
+        const struct task_snapshot *const snapshot = &task_snapshots[i];
+
+        /* 统计期间创建的任务从0开始计算 */
+        tick_t run_ticks = snapshot->run_ticks;
+        for (size_t j = 0; j < begin_count; ++j) {
+            if (top_tasks[j] == snapshot->task) {
+                run_ticks -= top_run_ticks[j];
+                break;
+            }
+        }
+
+        /* 千分比 */
+        const unsigned long permille = (unsigned long)(((uint64_t)run_ticks * 1000U) / elapsed);
+
+        console_printf("  %-12s %8lu %3lu.%lu%%\r\n", task_name(snapshot), (unsigned long)run_ticks,
+                       permille / 10U, permille % 10U);
+    }
+
+    return 0;
+}
+
+/* 堆内存统计 */
+static int console_kernel_cmd_heap_handler(int argc, char *argv[]) {
+#if (USE_DYNAMIC_MEMORY_ALLOCATION)
+    struct memory_stats stats;
+
+    memory_get_stats(&stats);
+
+    console_printf("  free          %zu\r\n", stats.free_size);
+    console_printf("  min ever free %zu\r\n", stats.min_ever_free_size);
+    console_printf("  largest block %zu\r\n", stats.largest_free_block);
+    console_printf("  free blocks   %zu\r\n", stats.free_block_count);
+    console_printf("  allocs        %zu\r\n", stats.alloc_count);
+    console_printf("  frees         %zu\r\n", stats.free_count);
+    console_printf("  failed allocs %zu\r\n", stats.failed_alloc_count);
+
+#else
+    console_printf("Dynamic memory allocation is disabled\r\n");
+
+#endif /* USE_DYNAMIC_MEMORY_ALLOCATION */
+
+    return 0;
+}
+
+/* 内存分配跟踪记录, 每行"时间戳 调用者 指针 大小", 由主机端工具 tools/heap_trace.py 分析 */
+static int console_kernel_cmd_heaptrace_handler(int argc, char *argv[]) {
+#if (USE_DYNAMIC_MEMORY_ALLOCATION && USE_MEMORY_TRACE)
+    const size_t count = memory_trace_copy(heaptrace_records, HEAPTRACE_SNAPSHOT_MAX);
+
+    console_printf("# tick caller ptr size\r\n");
+
+    for (size_t i = 0; i < count; ++i) {
+        const struct memory_trace_record *const record = &heaptrace_records[i];
+
+        console_printf("%lu 0x%08lx 0x%08lx %zu\r\n", (unsigned long)record->timestamp,
+                       (unsigned long)(uintptr_t)record->caller, (unsigned long)(uintptr_t)record->ptr, record->size);
+    }
+
+#else
+    console_printf("Heap trace is disabled\r\n");
+
+#endif /* USE_DYNAMIC_MEMORY_ALLOCATION && USE_MEMORY_TRACE */
+
+    return 0;
+}
+
+/* 内核对象 */
+static int console_kernel_cmd_queues_handler(int argc, char *argv[]) {
+    const size_t count = kobject_get_snapshot(kobject_infos, KOBJECT_SNAPSHOT_MAX);
+
+    console_printf("  %-12s %-10s %11s %7s\r\n", "NAME", "TYPE", "VALUE", "WAITING");
+
+    for (size_t i = 0; i < count; ++i) {
+        const struct kobject_info *const info = &kobject_infos[i];
+
+        console_printf("  %-12s %-10s ", (info->name != NULL) ? info->name : "-", info->type);
+
+        if (info->capacity != 0U) {
+            console_printf("%5zu/%-5zu ", info->value, info->capacity);
+        } else {
+            console_printf("0x%08zx  ", info->value);
+        }
+
+        console_printf("%7zu\r\n", info->waiting_count);
+    }
+
+    return 0;
+}
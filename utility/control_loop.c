@@ -0,0 +1,168 @@
+#include <string.h>
+#include <utility/control_loop.h>
+#include <utility/delay.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/compiler.h>
+#include <zhiyec/kernel.h>
+#include <zhiyec/task.h>
+#include <zhiyec/tick.h>
+
+/* 初始化控制回路 */
+void control_loop_init(struct control_loop *const loop, const tick_t period) {
+    assert(loop != NULL);
+    assert(period > 0U);
+
+    queue_list_init(loop->stages);
+    loop->period = period;
+    loop->cycle_count = 0U;
+    loop->overrun_count = 0U;
+}
+
+/* 添加阶段 */
+void control_loop_add(struct control_loop *const loop, struct control_stage *const stage,
+                      void (*const fn)(void *arg), void *const arg, const uint16_t divider,
+                      const uint16_t phase, const uint32_t budget_cycles) {
+    assert(loop != NULL);
+    assert(stage != NULL);
+    assert(fn != NULL);
+    assert(divider > 0U && phase < divider);
+
+    stage->fn = fn;
+    stage->arg = arg;
+    stage->divider = divider;
+    stage->phase = phase;
+    stage->countdown = phase;
+    stage->budget_cycles = budget_cycles;
+
+    stage->last_cycles = 0U;
+    stage->max_cycles = 0U;
+    stage->run_count = 0U;
+    stage->overrun_count = 0U;
+
+    queue_list_push(loop->stages, &(stage->node));
+}
+
+/* 执行阶段并记录执行时间 */
+static inline void control_loop_run_stage(struct control_stage *const stage) {
+    const uint32_t start_value = SYSTICK_VALUE_REG;
+
+    stage->fn(stage->arg);
+
+    const uint32_t cycles = delay_elapsed_cycles(start_value);
+
+    stage->last_cycles = cycles;
+    if (cycles > stage->max_cycles) {
+        stage->max_cycles = cycles;
+    }
+    if (stage->budget_cycles != 0U && cycles > stage->budget_cycles) {
+        ++stage->overrun_count;
+    }
+    ++stage->run_count;
+}
+
+/* 执行一个基本周期 */
+void control_loop_step(struct control_loop *const loop) {
+    assert(loop != NULL);
+
+    if (queue_list_is_empty(loop->stages)) {
+        return;
+    }
+
+    /* 用倒计数代替取模, 每个阶段的开销固定 */
+    for (struct slist_head *node = queue_list_front(loop->stages); node != NULL; node = node->next) {
+        struct control_stage *const stage = container_of(node, struct control_stage, node);
+
+        if (stage->countdown == 0U) {
+            stage->countdown = stage->divider - 1U;
+            control_loop_run_stage(stage);
+        } else {
+            --stage->countdown;
+        }
+    }
+
+    ++loop->cycle_count;
+}
+
+/* 控制回路任务 */
+void control_loop_task(void *arg) {
+    struct control_loop *const loop = (struct control_loop *)arg;
+
+    assert(loop != NULL);
+
+    tick_t wake_time = tick_get_current();
+
+    for (;;) {
+        const tick_t start_time = tick_get_current();
+
+        control_loop_step(loop);
+
+        /* 执行时间达到一个基本周期, 下一个周期将延迟开始 */
+        if (tick_get_current() - start_time >= loop->period) {
+            ++loop->overrun_count;
+        }
+
+        task_sleep_until(&wake_time, loop->period);
+    }
+}
+
+/* 初始化信号 */
+void control_signal_init(struct control_signal *const signal, void *const mem, const size_t size,
+                         const void *const init_value) {
+    assert(signal != NULL);
+    assert(mem != NULL);
+    assert(size > 0U);
+
+    signal->sequence = 0U;
+    signal->copies = mem;
+    signal->size = size;
+
+    if (init_value != NULL) {
+        memcpy(mem, init_value, size);
+        memcpy((byte *)mem + size, init_value, size);
+    } else {
+        memset(mem, 0, 2U * size);
+    }
+}
+
+/**
+ * 写入信号
+ * 两个副本轮流写入: 序号为奇数时读取者使用第二个副本, 此时写入第一个副本; 序号为偶数时相反
+ */
+void control_signal_write(struct control_signal *const signal, const void *const value) {
+    assert(signal != NULL);
+    assert(value != NULL);
+
+    byte *const copies = (byte *)signal->copies;
+
+    signal->sequence = signal->sequence + 1U;
+    compiler_barrier();
+    DMB();
+    memcpy(copies, value, signal->size);
+    compiler_barrier();
+    DMB();
+
+    signal->sequence = signal->sequence + 1U;
+    compiler_barrier();
+    DMB();
+    memcpy(copies + signal->size, value, signal->size);
+    compiler_barrier();
+    DMB();
+}
+
+/* 读取信号 */
+void control_signal_read(const struct control_signal *const signal, void *const value) {
+    assert(signal != NULL);
+    assert(value != NULL);
+
+    const byte *const copies = (const byte *)signal->copies;
+    uint32_t sequence;
+
+    do {
+        sequence = signal->sequence;
+        compiler_barrier();
+        DMB();
+        memcpy(value, copies + (sequence & 1U) * signal->size, signal->size);
+        compiler_barrier();
+        DMB();
+    } while (sequence != signal->sequence);
+}
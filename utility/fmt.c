@@ -1,83 +1,778 @@
+#include <asm/irq.h>
 #include <config.h>
 #include <stdarg.h>
-#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 #include <utility/fmt.h>
 #include <zhiyec/assert.h>
+#include <zhiyec/atomic.h>
 #include <zhiyec/compiler.h>
+#include <zhiyec/event_flags.h>
 #include <zhiyec/kernel.h>
 #include <zhiyec/reentrant_lock.h>
-
-#if (USE_DYNAMIC_MEMORY_ALLOCATION)
-#include <zhiyec/memory.h>
-#endif
+#include <zhiyec/semaphore.h>
+#include <zhiyec/task.h>
 
 static struct PrintStream current_out;
 static struct reentrantlock *print_lock = ALLOCATE_STACK(REENTRANTLOCK_BYTE);
+/* 持有打印锁的嵌套层数, 最外层结束时提交输出 */
+static unsigned int print_depth = 0U;
+
+/* 记录的已提交输出条数, 超过时与上一条合并 */
+#define FMT_ASYNC_RECORD_MAX 16U
+
+/**
+ * 异步输出缓冲区
+ * 打印者(持有打印锁)在head之后写入, 最外层结束时才将head移动到cursor, 因此发送者只会看到完整的输出;
+ * 数据依次为: [tail, flight_end) 发送者已取走正在发送, [flight_end, head) 已提交待发送, [head, cursor) 当前输出;
+ * 保留一个字节用于区分缓冲区空和满
+ */
+struct fmt_async_buffer {
+    char *buffer;
+    size_t size;
+    /* 已提交数据的结束位置 */
+    volatile size_t head;
+    /* 未释放数据的起始位置 */
+    volatile size_t tail;
+    /* 正在发送的数据的结束位置, 等于tail时没有数据在发送 */
+    volatile size_t flight_end;
+    /* 当前输出的写入位置 */
+    size_t cursor;
+    /* 未释放的已提交输出的结束位置(环形队列), 覆盖时按整条输出丢弃 */
+    size_t record_ends[FMT_ASYNC_RECORD_MAX];
+    size_t record_first;
+    size_t record_count;
+    /* 第一条未释放输出的起始位置 */
+    size_t record_start;
+    /* 当前输出已被丢弃 */
+    bool is_dropping;
+    /* 缓冲区满时的处理策略 */
+    enum fmt_overflow_policy policy;
+    /* 被丢弃的输出数量 */
+    volatile size_t dropped_count;
+};
+
+static struct fmt_async_buffer async_out = {.buffer = NULL};
+/* 有数据提交时通知输出任务 */
+static struct semaphore *drain_signal = ALLOCATE_STACK(SEMAPHORE_BYTE);
+/* 释放数据时通知等待空间的打印者(BLOCK策略), 释放可能发生在中断中, 使用事件标志唤醒 */
+static struct eventflags *space_event = ALLOCATE_STACK(EVENTFLAGS_BYTE);
+
+#define FMT_ASYNC_EVENT_SPACE 0x01U
+
+#define fmt_is_async() (async_out.buffer != NULL)
+
+/* 环形缓冲区中从from到to的数据长度 */
+#define fmt_ring_distance(from, to, size) (((to) >= (from)) ? ((to) - (from)) : ((size) - (from) + (to)))
+
+/* 环形缓冲区的位置前进 */
+#define fmt_ring_advance(pos, n, size) (((pos) + (n) >= (size)) ? ((pos) + (n) - (size)) : ((pos) + (n)))
+
+/* 缓冲区已满(当前输出的写入位置紧接未释放数据的起始位置) */
+#define fmt_async_is_full() (fmt_ring_advance(async_out.cursor, 1U, async_out.size) == async_out.tail)
 
 void fmt_init(struct PrintStream *print_stream, const enum task_priority print_lock_ceiling_priority) {
     current_out = *print_stream;
     reentrantlock_init(print_lock, print_lock_ceiling_priority);
 }
 
-always_inline void fmt_print(const char *str) {
-    assert(current_out.write != NULL);
+void fmt_enable_async(char *const buffer, const size_t size, const enum fmt_overflow_policy policy) {
+    assert(buffer != NULL);
+    assert(size >= 2U);
 
-    reentrantlock_lock(print_lock);
+    semaphore_init_counting(drain_signal, 1, 0U);
+    eventflags_init(space_event, 0U);
+
+    async_out.size = size;
+    async_out.head = 0U;
+    async_out.tail = 0U;
+    async_out.flight_end = 0U;
+    async_out.cursor = 0U;
+    async_out.record_first = 0U;
+    async_out.record_count = 0U;
+    async_out.record_start = 0U;
+    async_out.is_dropping = false;
+    async_out.policy = policy;
+    async_out.dropped_count = 0U;
+    async_out.buffer = buffer;
+}
+
+/* 写入打印流 */
+static void fmt_stream_write(const char *const str, const size_t length) {
+    if (current_out.write_block != NULL) {
+        current_out.write_block(str, length);
+        return;
+    }
 
-    for (size_t i = 0; str[i] != '\0'; ++i) {
+    for (size_t i = 0; i < length; ++i) {
         current_out.write(str[i]);
     }
+}
 
-    reentrantlock_unlock(print_lock);
+/* 丢弃当前输出 */
+static inline void fmt_async_drop(void) {
+    async_out.cursor = async_out.head;
+    async_out.is_dropping = true;
+    ++async_out.dropped_count;
 }
 
-void fmt_println(const char *str) {
-    assert(current_out.write != NULL);
+/* 缓冲区满时按策略腾出空间, 返回是否继续写入当前输出 */
+static bool fmt_async_make_room(void) {
+    switch (async_out.policy) {
+    case FMT_OVERFLOW_BLOCK:
+        /* 先清除事件再检查空间, 检查之后的释放不会丢失; 通知输出任务发送数据后阻塞, 直到 fmt_async_consume 释放数据 */
+        eventflags_clear(space_event, FMT_ASYNC_EVENT_SPACE);
+        if (fmt_async_is_full()) {
+            semaphore_release(drain_signal);
+            (void)eventflags_wait(space_event, FMT_ASYNC_EVENT_SPACE, EVENTFLAGS_WAIT_ANY | EVENTFLAGS_CLEAR_ON_EXIT);
+        }
+        return true;
+
+    case FMT_OVERFLOW_OVERWRITE: {
+        /**
+         * 丢弃最旧的一条完整输出; 只有在没有数据正在发送且最旧的输出没有被发送一部分时才能丢弃,
+         * 否则腾出的空间与写入位置不相邻, 改为丢弃当前输出
+         */
+        bool is_overwritten = false;
+
+        atomic_begin();
+        if (async_out.flight_end == async_out.tail && async_out.tail == async_out.record_start &&
+            async_out.record_count > 0U) {
+            async_out.tail = async_out.record_ends[async_out.record_first];
+            async_out.flight_end = async_out.tail;
+            async_out.record_start = async_out.tail;
+            async_out.record_first = (async_out.record_first + 1U) % FMT_ASYNC_RECORD_MAX;
+            --async_out.record_count;
+            is_overwritten = true;
+        }
+        atomic_end();
+
+        if (is_overwritten) {
+            ++async_out.dropped_count;
+            return true;
+        }
+
+        fmt_async_drop();
+        return false;
+    }
+
+    default:
+        fmt_async_drop();
+        return false;
+    }
+}
+
+/* 写入异步缓冲区(未提交) */
+static void fmt_async_write(const char *str, size_t length) {
+    /* 超过缓冲区容量的输出无论如何都放不下, 直接丢弃, 避免覆盖或等待 */
+    if (!async_out.is_dropping &&
+        fmt_ring_distance(async_out.head, async_out.cursor, async_out.size) + length > async_out.size - 1U) {
+        fmt_async_drop();
+        return;
+    }
+
+    while (length > 0U && !async_out.is_dropping) {
+        const size_t tail = async_out.tail;
+        const size_t cursor = async_out.cursor;
+
+        /* 可连续写入的空间 */
+        size_t space = (tail > cursor) ? (tail - cursor - 1U) : (async_out.size - cursor - ((tail == 0U) ? 1U : 0U));
+
+        if (space == 0U) {
+            if (!fmt_async_make_room()) {
+                return;
+            }
+            continue;
+        }
+
+        if (space > length) {
+            space = length;
+        }
+
+        memcpy(&async_out.buffer[cursor], str, space);
+        async_out.cursor = fmt_ring_advance(cursor, space, async_out.size);
+
+        str += space;
+        length -= space;
+    }
+}
+
+/* 提交当前输出 */
+static void fmt_async_commit(void) {
+    if (async_out.cursor != async_out.head) {
+        atomic_begin();
+        if (async_out.record_count < FMT_ASYNC_RECORD_MAX) {
+            ++async_out.record_count;
+        }
+        /* 记录已满时与上一条合并 */
+        async_out.record_ends[(async_out.record_first + async_out.record_count - 1U) % FMT_ASYNC_RECORD_MAX] =
+            async_out.cursor;
+        async_out.head = async_out.cursor;
+        atomic_end();
+
+        semaphore_release(drain_signal);
+    }
+
+    async_out.is_dropping = false;
+}
+
+/* 输出字符串, 需持有打印锁 */
+static void fmt_write(const char *const str, const size_t length) {
+    if (fmt_is_async()) {
+        fmt_async_write(str, length);
+    } else {
+        fmt_stream_write(str, length);
+    }
+}
+
+static inline void fmt_begin(void) {
+    assert(current_out.write != NULL || current_out.write_block != NULL);
 
     reentrantlock_lock(print_lock);
+    ++print_depth;
+}
 
-    fmt_print(str);
-    current_out.write('\r');
-    current_out.write('\n');
+static inline void fmt_end(void) {
+    if (--print_depth == 0U && fmt_is_async()) {
+        fmt_async_commit();
+    }
 
     reentrantlock_unlock(print_lock);
 }
 
+void fmt_print(const char *str) {
+    fmt_begin();
+    fmt_write(str, strlen(str));
+    fmt_end();
+}
+
+void fmt_println(const char *str) {
+    fmt_begin();
+    fmt_write(str, strlen(str));
+    fmt_write("\r\n", 2U);
+    fmt_end();
+}
+
+/**
+ * 内置格式化引擎
+ * 直接流式输出, 不分配内存; 仅使用一个小的分块缓冲区合并写入, 无递归, 栈用量固定
+ */
+
+/* 分块缓冲区大小 */
+#define FMT_CHUNK_SIZE 32U
+/* 数字缓冲区大小(可容纳unsigned long long的数字, 也足够容纳10位整数部分 + 小数点 + 9位小数) */
+#define FMT_NUMBER_SIZE (sizeof(unsigned long long) * 8U / 3U + 1U)
+/* 浮点数的最大精度 */
+#define FMT_FLOAT_PRECISION_MAX 9U
+
+enum fmt_flag {
+    FMT_FLAG_LEFT = 0x01U,
+    FMT_FLAG_ZERO = 0x02U,
+    FMT_FLAG_PLUS = 0x04U,
+    FMT_FLAG_SPACE = 0x08U,
+    FMT_FLAG_ALTERNATE = 0x10U,
+    FMT_FLAG_UPPER = 0x20U,
+};
+
+/* 长度修饰 */
+enum fmt_length {
+    FMT_LENGTH_NONE,
+    FMT_LENGTH_CHAR,      // hh
+    FMT_LENGTH_SHORT,     // h
+    FMT_LENGTH_LONG,      // l
+    FMT_LENGTH_LONG_LONG, // ll
+    FMT_LENGTH_INTMAX,    // j
+    FMT_LENGTH_SIZE,      // z
+};
+
+struct fmt_spec {
+    unsigned int flags;
+    unsigned int width;
+    /* 精度, 为-1时未指定 */
+    int precision;
+};
+
+struct fmt_output {
+    char chunk[FMT_CHUNK_SIZE];
+    size_t length;
+};
+
+static inline void fmt_out_flush(struct fmt_output *const out) {
+    if (out->length > 0U) {
+        fmt_write(out->chunk, out->length);
+        out->length = 0U;
+    }
+}
+
+static inline void fmt_out_char(struct fmt_output *const out, const char ch) {
+    out->chunk[out->length++] = ch;
+
+    if (out->length == FMT_CHUNK_SIZE) {
+        fmt_out_flush(out);
+    }
+}
+
+static void fmt_out_repeat(struct fmt_output *const out, const char ch, size_t count) {
+    while (count-- > 0U) {
+        fmt_out_char(out, ch);
+    }
+}
+
+static void fmt_out_string(struct fmt_output *const out, const char *const str, const size_t length) {
+    /* 较长的字符串直接写入, 不经过分块缓冲区 */
+    if (length >= FMT_CHUNK_SIZE) {
+        fmt_out_flush(out);
+        fmt_write(str, length);
+        return;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        fmt_out_char(out, str[i]);
+    }
+}
+
+/* 输出字段: 宽度填充 + 前缀(符号, 0x) + 精度补零 + 内容 */
+static void fmt_out_field(struct fmt_output *const out, const struct fmt_spec *const spec,
+                          const char *const prefix, const size_t prefix_length, const size_t zeros,
+                          const char *const body, const size_t body_length) {
+    const size_t length = prefix_length + zeros + body_length;
+    const size_t padding = (spec->width > length) ? (spec->width - length) : 0U;
+
+    if (!(spec->flags & (FMT_FLAG_LEFT | FMT_FLAG_ZERO))) {
+        fmt_out_repeat(out, ' ', padding);
+    }
+
+    fmt_out_string(out, prefix, prefix_length);
+
+    if ((spec->flags & (FMT_FLAG_LEFT | FMT_FLAG_ZERO)) == FMT_FLAG_ZERO) {
+        fmt_out_repeat(out, '0', padding);
+    }
+
+    fmt_out_repeat(out, '0', zeros);
+    fmt_out_string(out, body, body_length);
+
+    if (spec->flags & FMT_FLAG_LEFT) {
+        fmt_out_repeat(out, ' ', padding);
+    }
+}
+
+/* 将无符号整数转换为数字, 从缓冲区末尾向前写入, 返回数字个数 */
+static size_t fmt_utoa(char *const end, unsigned long long value, const unsigned int base, const bool is_upper) {
+    const char *const digits = is_upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    size_t count = 0U;
+
+    /* 超出unsigned long的高位部分按64位除法转换, 其余按字长转换, 32位目标上的常见情况不调用64位除法 */
+    while ((unsigned long)value != value) {
+        *(end - ++count) = digits[value % base];
+        value /= base;
+    }
+
+    unsigned long word = (unsigned long)value;
+
+    do {
+        *(end - ++count) = digits[word % base];
+        word /= base;
+    } while (word != 0U);
+
+    return count;
+}
+
+/* 符号前缀 */
+static inline size_t fmt_sign(char *const prefix, const bool is_negative, const unsigned int flags) {
+    if (is_negative) {
+        *prefix = '-';
+    } else if (flags & FMT_FLAG_PLUS) {
+        *prefix = '+';
+    } else if (flags & FMT_FLAG_SPACE) {
+        *prefix = ' ';
+    } else {
+        return 0U;
+    }
+
+    return 1U;
+}
+
+/* 输出整数 */
+static void fmt_out_integer(struct fmt_output *const out, struct fmt_spec *const spec, const unsigned long long value,
+                            const bool is_negative, const unsigned int base, const char *const base_prefix) {
+    char number[FMT_NUMBER_SIZE];
+    char prefix[3];
+    size_t prefix_length = fmt_sign(prefix, is_negative, spec->flags);
+
+    for (size_t i = 0; base_prefix[i] != '\0'; ++i) {
+        prefix[prefix_length++] = base_prefix[i];
+    }
+
+    size_t length = fmt_utoa(number + FMT_NUMBER_SIZE, value, base, spec->flags & FMT_FLAG_UPPER);
+
+    /* 精度为0时数值0不输出数字 */
+    if (spec->precision == 0 && value == 0U) {
+        length = 0U;
+    }
+
+    size_t zeros = 0U;
+    if (spec->precision >= 0) {
+        /* 指定精度时忽略'0'标志 */
+        spec->flags &= ~FMT_FLAG_ZERO;
+
+        if ((size_t)spec->precision > length) {
+            zeros = (size_t)spec->precision - length;
+        }
+    }
+
+    fmt_out_field(out, spec, prefix, prefix_length, zeros, number + FMT_NUMBER_SIZE - length, length);
+}
+
+/* 输出定点格式的浮点数 */
+static void fmt_out_float(struct fmt_output *const out, struct fmt_spec *const spec, double value) {
+    char number[FMT_NUMBER_SIZE];
+    char prefix[1];
+
+    /* 非数值与超出范围的值 */
+    const char *special = NULL;
+    if (value != value) {
+        special = "nan";
+    } else if (value >= 4294967295.0 || value <= -4294967295.0) {
+        special = (value > 0.0) ? "+ovf" : "-ovf";
+    }
+
+    if (special != NULL) {
+        spec->flags &= ~FMT_FLAG_ZERO;
+        fmt_out_field(out, spec, NULL, 0U, 0U, special, strlen(special));
+        return;
+    }
+
+    const bool is_negative = (value < 0.0);
+    if (is_negative) {
+        value = -value;
+    }
+
+    unsigned int precision = (spec->precision < 0) ? 6U : (unsigned int)spec->precision;
+    if (precision > FMT_FLOAT_PRECISION_MAX) {
+        precision = FMT_FLOAT_PRECISION_MAX;
+    }
+
+    uint32_t scale = 1U;
+    for (unsigned int i = 0; i < precision; ++i) {
+        scale *= 10U;
+    }
+
+    /* 四舍五入, 进位到整数部分 */
+    uint32_t integer = (uint32_t)value;
+    uint32_t fraction = (uint32_t)((value - (double)integer) * (double)scale + 0.5);
+    if (fraction >= scale) {
+        fraction -= scale;
+        ++integer;
+    }
+
+    /* 从末尾向前写入: 小数部分, 小数点, 整数部分 */
+    char *pos = number + FMT_NUMBER_SIZE;
+    if (precision > 0U) {
+        const size_t count = fmt_utoa(pos, fraction, 10U, false);
+        pos -= count;
+        for (size_t i = count; i < precision; ++i) {
+            *--pos = '0';
+        }
+        *--pos = '.';
+    }
+    pos -= fmt_utoa(pos, integer, 10U, false);
+
+    const size_t prefix_length = fmt_sign(prefix, is_negative, spec->flags);
+    fmt_out_field(out, spec, prefix, prefix_length, 0U, pos, (size_t)(number + FMT_NUMBER_SIZE - pos));
+}
+
+/* 解析非负整数 */
+static inline unsigned int fmt_parse_number(const char **const format) {
+    unsigned int value = 0U;
+
+    while (**format >= '0' && **format <= '9') {
+        value = value * 10U + (unsigned int)(**format - '0');
+        ++(*format);
+    }
+
+    return value;
+}
+
+/* 格式化输出, 需持有打印锁 */
+static void fmt_format(struct fmt_output *const out, const char *format, va_list args) {
+    while (*format != '\0') {
+        if (*format != '%') {
+            fmt_out_char(out, *format++);
+            continue;
+        }
+
+        const char *const spec_start = format++;
+        struct fmt_spec spec = {.flags = 0U, .width = 0U, .precision = -1};
+
+        /* 标志 */
+        for (;; ++format) {
+            if (*format == '-') {
+                spec.flags |= FMT_FLAG_LEFT;
+            } else if (*format == '0') {
+                spec.flags |= FMT_FLAG_ZERO;
+            } else if (*format == '+') {
+                spec.flags |= FMT_FLAG_PLUS;
+            } else if (*format == ' ') {
+                spec.flags |= FMT_FLAG_SPACE;
+            } else if (*format == '#') {
+                spec.flags |= FMT_FLAG_ALTERNATE;
+            } else {
+                break;
+            }
+        }
+
+        /* 宽度 */
+        if (*format == '*') {
+            const int width = va_arg(args, int);
+            if (width < 0) {
+                spec.flags |= FMT_FLAG_LEFT;
+                spec.width = (unsigned int)-width;
+            } else {
+                spec.width = (unsigned int)width;
+            }
+            ++format;
+        } else {
+            spec.width = fmt_parse_number(&format);
+        }
+
+        /* 精度 */
+        if (*format == '.') {
+            ++format;
+            if (*format == '*') {
+                const int precision = va_arg(args, int);
+                spec.precision = (precision < 0) ? -1 : precision;
+                ++format;
+            } else {
+                spec.precision = (int)fmt_parse_number(&format);
+            }
+        }
+
+        /* 长度修饰, 只接受一个; 其后仍是长度修饰时按不支持的转换原样输出 */
+        enum fmt_length length = FMT_LENGTH_NONE;
+        if (*format == 'h') {
+            length = FMT_LENGTH_SHORT;
+            if (*++format == 'h') {
+                length = FMT_LENGTH_CHAR;
+                ++format;
+            }
+        } else if (*format == 'l') {
+            length = FMT_LENGTH_LONG;
+            if (*++format == 'l') {
+                length = FMT_LENGTH_LONG_LONG;
+                ++format;
+            }
+        } else if (*format == 'j') {
+            ++format;
+            length = FMT_LENGTH_INTMAX;
+        } else if (*format == 'z') {
+            ++format;
+            length = FMT_LENGTH_SIZE;
+        }
+
+        switch (*format) {
+        case 'd':
+        case 'i': {
+            /* 按修饰读取参数, h和hh截断为对应的类型 */
+            const long long value = (length == FMT_LENGTH_CHAR)        ? (signed char)va_arg(args, int)
+                                    : (length == FMT_LENGTH_SHORT)     ? (short)va_arg(args, int)
+                                    : (length == FMT_LENGTH_LONG)      ? va_arg(args, long)
+                                    : (length == FMT_LENGTH_LONG_LONG) ? va_arg(args, long long)
+                                    : (length == FMT_LENGTH_INTMAX)    ? (long long)va_arg(args, intmax_t)
+                                    : (length == FMT_LENGTH_SIZE)      ? (long long)va_arg(args, size_t)
+                                                                       : va_arg(args, int);
+            const unsigned long long magnitude =
+                (value < 0) ? (0ULL - (unsigned long long)value) : (unsigned long long)value;
+            fmt_out_integer(out, &spec, magnitude, value < 0, 10U, "");
+            break;
+        }
+
+        case 'u':
+        case 'x':
+        case 'X': {
+            const unsigned long long value =
+                (length == FMT_LENGTH_CHAR)        ? (unsigned char)va_arg(args, unsigned int)
+                : (length == FMT_LENGTH_SHORT)     ? (unsigned short)va_arg(args, unsigned int)
+                : (length == FMT_LENGTH_LONG)      ? va_arg(args, unsigned long)
+                : (length == FMT_LENGTH_LONG_LONG) ? va_arg(args, unsigned long long)
+                : (length == FMT_LENGTH_INTMAX)    ? (unsigned long long)va_arg(args, uintmax_t)
+                : (length == FMT_LENGTH_SIZE)      ? (unsigned long long)va_arg(args, size_t)
+                                                   : va_arg(args, unsigned int);
+            if (*format == 'X') {
+                spec.flags |= FMT_FLAG_UPPER;
+            }
+            spec.flags &= ~(FMT_FLAG_PLUS | FMT_FLAG_SPACE);
+
+            /* '#'标志: 非零的十六进制数加前缀 */
+            const char *base_prefix = "";
+            if (*format != 'u' && (spec.flags & FMT_FLAG_ALTERNATE) && value != 0U) {
+                base_prefix = (*format == 'X') ? "0X" : "0x";
+            }
+
+            fmt_out_integer(out, &spec, value, false, (*format == 'u') ? 10U : 16U, base_prefix);
+            break;
+        }
+
+        case 'p': {
+            spec.flags &= ~(FMT_FLAG_PLUS | FMT_FLAG_SPACE);
+            if (spec.precision < 0) {
+                spec.precision = (int)(sizeof(void *) * 2U);
+            }
+            fmt_out_integer(out, &spec, (unsigned long)(uintptr_t)va_arg(args, void *), false, 16U, "0x");
+            break;
+        }
+
+        case 'c': {
+            const char ch = (char)va_arg(args, int);
+            spec.flags &= ~FMT_FLAG_ZERO;
+            fmt_out_field(out, &spec, NULL, 0U, 0U, &ch, 1U);
+            break;
+        }
+
+        case 's': {
+            const char *str = va_arg(args, const char *);
+            if (str == NULL) {
+                str = "(null)";
+            }
+
+            /* 精度限制输出的最大字符数 */
+            size_t length = 0U;
+            while (str[length] != '\0' && (spec.precision < 0 || length < (size_t)spec.precision)) {
+                ++length;
+            }
+
+            spec.flags &= ~FMT_FLAG_ZERO;
+            fmt_out_field(out, &spec, NULL, 0U, 0U, str, length);
+            break;
+        }
+
+        case 'f':
+        case 'F':
+            fmt_out_float(out, &spec, va_arg(args, double));
+            break;
+
+        case '%':
+            fmt_out_char(out, '%');
+            break;
+
+        default:
+            /* 不支持的转换, 原样输出 */
+            if (*format == '\0') {
+                fmt_out_string(out, spec_start, (size_t)(format - spec_start));
+                return;
+            }
+            fmt_out_string(out, spec_start, (size_t)(format - spec_start) + 1U);
+            break;
+        }
+
+        ++format;
+    }
+}
+
+void fmt_vprintf(const char *format, va_list args) {
+    struct fmt_output out;
+    out.length = 0U;
+
+    fmt_begin();
+    fmt_format(&out, format, args);
+    fmt_out_flush(&out);
+    fmt_end();
+}
+
 void fmt_printf(const char *format, ...) {
     va_list args;
     va_start(args, format);
+    fmt_vprintf(format, args);
+    va_end(args);
+}
+
+/* 获取连续的待发送数据 */
+size_t fmt_async_get_pending(const char **const data) {
+    assert(data != NULL);
+
+    if (!fmt_is_async()) {
+        return 0U;
+    }
 
-#if (USE_DYNAMIC_MEMORY_ALLOCATION)
-    va_list args_copy;
-    va_copy(args_copy, args);
-    /* 计算格式化的字符串长度, +1 为包含'\0'的长度 */
-    const size_t string_length = vsnprintf(NULL, 0U, format, args_copy) + 1;
-    va_end(args_copy);
-    char *string = memory_alloc(string_length * sizeof(char));
-    if (string == NULL) {
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    const size_t tail = async_out.tail;
+    size_t length;
+
+    if (async_out.flight_end != tail) {
+        /* 上一次取走的数据还没有释放, 返回同一段数据 */
+        length = fmt_ring_distance(tail, async_out.flight_end, async_out.size);
+    } else {
+        const size_t head = async_out.head;
+
+        length = (head >= tail) ? (head - tail) : (async_out.size - tail);
+        /* 标记为正在发送, 覆盖策略不会丢弃这段数据 */
+        async_out.flight_end = fmt_ring_advance(tail, length, async_out.size);
+    }
+
+    *data = &async_out.buffer[tail];
+
+    irq_enable_from_isr(prev_basepri);
+
+    return length;
+}
+
+/* 释放已发送的数据 */
+void fmt_async_consume(const size_t length) {
+    if (!fmt_is_async()) {
         return;
     }
-#else
-    char string[128];
-    const size_t string_length = sizeof(string) / sizeof(string[0]);
-#endif
 
-    /* 格式化字符串到字符数组中 */
-    const int length = vsnprintf(string, string_length, format, args);
-    va_end(args);
+    uint32_t prev_basepri = irq_disable_from_isr();
+
+    /* 只能释放已取走的数据 */
+    const size_t in_flight = fmt_ring_distance(async_out.tail, async_out.flight_end, async_out.size);
+    const size_t count = (length < in_flight) ? length : in_flight;
+
+    async_out.tail = fmt_ring_advance(async_out.tail, count, async_out.size);
+
+    /* 移除已全部释放的输出 */
+    while (async_out.record_count > 0U) {
+        const size_t end = async_out.record_ends[async_out.record_first];
+        const size_t record_length = fmt_ring_distance(async_out.record_start, end, async_out.size);
+        const size_t released = fmt_ring_distance(async_out.record_start, async_out.tail, async_out.size);
 
-    /* 字符串过长, 省略 */
-    if ((length >= string_length) && (string_length >= 4U)) {
-        size_t i = string_length - 1 - 3;
-        for (; i < string_length - 1; ++i) {
-            string[i] = '.';
+        if (released < record_length) {
+            break;
         }
-        string[i] = '\0';
+
+        async_out.record_start = end;
+        async_out.record_first = (async_out.record_first + 1U) % FMT_ASYNC_RECORD_MAX;
+        --async_out.record_count;
+    }
+
+    irq_enable_from_isr(prev_basepri);
+
+    if (count > 0U) {
+        (void)eventflags_set_from_isr(space_event, FMT_ASYNC_EVENT_SPACE);
+    }
+}
+
+/* 发送已提交的数据 */
+void fmt_flush(void) {
+    const char *data;
+    size_t length;
+
+    while ((length = fmt_async_get_pending(&data)) > 0U) {
+        fmt_stream_write(data, length);
+        fmt_async_consume(length);
     }
+}
 
-    fmt_print(string);
+void fmt_drain_task(void *arg) {
+    (void)arg;
+
+    for (;;) {
+        semaphore_acquire(drain_signal);
+        fmt_flush();
+    }
+}
 
-#if (USE_DYNAMIC_MEMORY_ALLOCATION)
-    memory_free(string);
-#endif
+size_t fmt_async_get_dropped(void) {
+    return async_out.dropped_count;
 }
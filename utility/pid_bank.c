@@ -0,0 +1,129 @@
+#include <asm/simd.h>
+#include <string.h>
+#include <utility/pid_bank.h>
+#include <zhiyec/assert.h>
+#include <zhiyec/compiler.h>
+
+/* Q31饱和 */
+static always_inline int32_t pid_bank_saturate(const int64_t x, const int32_t min, const int32_t max) {
+    if (x > max) {
+        return max;
+    }
+    if (x < min) {
+        return min;
+    }
+    return (int32_t)x;
+}
+
+/* 16位饱和 */
+static always_inline int32_t pid_bank_saturate16(const int32_t x) {
+    return (x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : x);
+}
+
+/**
+ * 由比例微分项和积分增量计算输出
+ * 两者均为Q15乘Q15(Q30), 还需放大 2^gain_shift
+ */
+static always_inline int16_t pid_bank_finish(struct pid_bank *const bank, const size_t i,
+                                             const int32_t proportional_derivative, const int32_t increment,
+                                             const int32_t error) {
+    const unsigned int shift = 1U + bank->gain_shift;
+    const int32_t output_min = (int32_t)bank->output_min[i] * 65536;
+    const int32_t output_max = (int32_t)bank->output_max[i] * 65536;
+
+    const int64_t pd = (int64_t)proportional_derivative << shift;
+    const int32_t integral =
+        pid_bank_saturate((int64_t)bank->integral[i] + ((int64_t)increment << shift), output_min, output_max);
+
+    /* 钳位抗饱和: 积分后输出饱和且误差与饱和方向相同时, 放弃本次积分 */
+    int64_t output = pd + integral;
+    if (!((output > output_max && error > 0) || (output < output_min && error < 0))) {
+        bank->integral[i] = integral;
+    } else {
+        output = pd + bank->integral[i];
+    }
+
+    return (int16_t)(pid_bank_saturate(output, output_min, output_max) >> 16);
+}
+
+/* 清除所有控制器的积分和微分状态 */
+void pid_bank_reset(struct pid_bank *const bank, const int16_t *const measurement) {
+    assert(bank);
+    assert(bank->kp && bank->ki && bank->kd);
+    assert(bank->output_min && bank->output_max);
+    assert(bank->integral && bank->prev_measurement);
+    assert(bank->gain_shift < 16U);
+
+    for (size_t i = 0; i < bank->count; ++i) {
+        assert(bank->kp[i] != INT16_MIN && bank->kd[i] != INT16_MIN);
+        assert(bank->output_min[i] < bank->output_max[i]);
+
+        bank->integral[i] = 0;
+        bank->prev_measurement[i] = (measurement != NULL) ? measurement[i] : 0;
+    }
+}
+
+#if (ARCH_HAS_DSP_SIMD)
+
+/* 读取两个相邻的16位数 */
+static always_inline uint32_t pid_bank_load2(const int16_t *const p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/* 同时计算两个控制器 */
+static always_inline void pid_bank_update2(struct pid_bank *const bank, const size_t i,
+                                           const int16_t *const setpoint, const int16_t *const measurement,
+                                           int16_t *const output) {
+    const uint32_t measurement2 = pid_bank_load2(&measurement[i]);
+
+    /* 误差和测量值变化(饱和到Q15) */
+    const uint32_t error2 = simd_qsub16(pid_bank_load2(&setpoint[i]), measurement2);
+    const uint32_t delta2 = simd_qsub16(measurement2, pid_bank_load2(&bank->prev_measurement[i]));
+    memcpy(&bank->prev_measurement[i], &measurement2, sizeof(measurement2));
+
+    const uint32_t kp2 = pid_bank_load2(&bank->kp[i]);
+    const uint32_t kd2 = pid_bank_load2(&bank->kd[i]);
+    const uint32_t ki2 = pid_bank_load2(&bank->ki[i]);
+
+    /* kp * e - kd * Δy, 一条指令完成两次乘法 */
+    const int32_t pd0 = simd_smusd(simd_pack_bottom(error2, delta2), simd_pack_bottom(kp2, kd2));
+    const int32_t pd1 = simd_smusd(simd_pack_top(error2, delta2), simd_pack_top(kp2, kd2));
+
+    output[i] = pid_bank_finish(bank, i, pd0, simd_smulbb(ki2, error2), (int16_t)error2);
+    output[i + 1U] = pid_bank_finish(bank, i + 1U, pd1, simd_smultt(ki2, error2), (int16_t)(error2 >> 16));
+}
+
+#endif /* ARCH_HAS_DSP_SIMD */
+
+/* 计算一个控制器 */
+static always_inline void pid_bank_update1(struct pid_bank *const bank, const size_t i,
+                                           const int16_t *const setpoint, const int16_t *const measurement,
+                                           int16_t *const output) {
+    const int32_t error = pid_bank_saturate16((int32_t)setpoint[i] - measurement[i]);
+    const int32_t delta = pid_bank_saturate16((int32_t)measurement[i] - bank->prev_measurement[i]);
+
+    bank->prev_measurement[i] = measurement[i];
+
+    output[i] = pid_bank_finish(bank, i, bank->kp[i] * error - bank->kd[i] * delta, bank->ki[i] * error, error);
+}
+
+/* 计算所有控制器 */
+void pid_bank_update(struct pid_bank *const bank, const int16_t *const setpoint,
+                     const int16_t *const measurement, int16_t *const output) {
+    assert(bank);
+    assert(setpoint && measurement && output);
+
+    size_t i = 0;
+
+#if (ARCH_HAS_DSP_SIMD)
+    for (; i + 1U < bank->count; i += 2U) {
+        pid_bank_update2(bank, i, setpoint, measurement, output);
+    }
+#endif
+
+    for (; i < bank->count; ++i) {
+        pid_bank_update1(bank, i, setpoint, measurement, output);
+    }
+}
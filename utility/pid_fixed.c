@@ -0,0 +1,153 @@
+#include <utility/pid_fixed.h>
+#include <zhiyec/assert.h>
+
+/* 增益的小数位数 */
+#define PIDFIXED_GAIN_FRAC_BITS 16
+
+/* Q15与Q31之间的转换 */
+#define q15_to_q31(x) ((int32_t)(x) * 65536)
+#define q31_to_q15(x) ((int16_t)((x) >> 16))
+
+struct pid_fixed {
+    /* 比例增益 */
+    int32_t kp;
+    /* 积分增益乘采样周期 */
+    int32_t ki_dt;
+    /* 反馈计算增益(采样周期除以跟踪时间常数) */
+    int32_t kb_dt;
+    /* 微分滤波系数: D[n] = d_decay * D[n-1] - d_gain * (y[n] - y[n-1]) */
+    int32_t d_decay;
+    int32_t d_gain;
+
+    /* 积分项(Q31) */
+    int32_t integral;
+    /* 微分项(Q31) */
+    int32_t derivative;
+    /* 输出范围(Q31) */
+    int32_t output_min;
+    int32_t output_max;
+
+    /* 上一次测量值 */
+    int16_t prev_measurement;
+    /* PID输出 */
+    volatile int16_t pid_output;
+    /* 积分抗饱和方式 */
+    uint8_t antiwindup;
+};
+
+static_assert(PIDFIXED_BYTE == sizeof(struct pid_fixed), "size mismatch");
+
+/* 浮点增益转换为Q16.16 */
+static int32_t pid_fixed_gain(const float gain) {
+    const float scaled = gain * (float)(1L << PIDFIXED_GAIN_FRAC_BITS);
+
+    assert(scaled < 2147483647.0f && scaled > -2147483648.0f);
+
+    return (int32_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+/* Q31饱和 */
+static inline int32_t pid_fixed_saturate(const int64_t x, const int32_t min, const int32_t max) {
+    if (x > max) {
+        return max;
+    }
+    if (x < min) {
+        return min;
+    }
+    return (int32_t)x;
+}
+
+/* Q15或Q31乘以Q16.16增益, 结果的小数位数为输入的小数位数加16 */
+static inline int64_t pid_fixed_mul(const int32_t x, const int32_t gain) {
+    return (int64_t)x * gain;
+}
+
+/* 初始化定点PID控制器 */
+struct pid_fixed *pid_fixed_init(void *const pid_mem, const struct pid_fixed_config *const config) {
+    assert(pid_mem);
+    assert(config);
+    assert(config->dt > 0.0f && config->tf >= 0.0f);
+    assert(config->output_min < config->output_max);
+
+    struct pid_fixed *pid = (struct pid_fixed *)pid_mem;
+
+    pid->kp = pid_fixed_gain(config->kp);
+    pid->ki_dt = pid_fixed_gain(config->ki * config->dt);
+
+    /* 后向欧拉离散化的一阶滤波微分: D = kd * s / (tf * s + 1) */
+    pid->d_decay = pid_fixed_gain(config->tf / (config->tf + config->dt));
+    pid->d_gain = pid_fixed_gain(config->kd / (config->tf + config->dt));
+
+    pid->antiwindup = (uint8_t)config->antiwindup;
+    if (config->antiwindup == PIDFIXED_ANTIWINDUP_BACK_CALCULATION) {
+        assert(config->tt > 0.0f);
+        pid->kb_dt = pid_fixed_gain(config->dt / config->tt);
+    } else {
+        pid->kb_dt = 0;
+    }
+
+    pid->output_min = q15_to_q31(config->output_min);
+    pid->output_max = q15_to_q31(config->output_max);
+
+    pid_fixed_reset(pid, 0);
+
+    return pid;
+}
+
+/* 清除积分和微分状态 */
+void pid_fixed_reset(struct pid_fixed *const pid, const int16_t measurement) {
+    pid->integral = 0;
+    pid->derivative = 0;
+    pid->prev_measurement = measurement;
+    pid->pid_output = 0;
+}
+
+/* 计算PID */
+int16_t pid_fixed_cal_output(struct pid_fixed *const pid, const int16_t setpoint, const int16_t measurement) {
+    const int32_t error = (int32_t)setpoint - measurement;
+
+    /* 比例项: Q15 * Q16.16 = Q31 */
+    const int64_t proportional = pid_fixed_mul(error, pid->kp);
+
+    /* 微分项: 只对测量值求导, 避免目标值突变时的微分冲击 */
+    const int32_t delta_measurement = (int32_t)measurement - pid->prev_measurement;
+    pid->derivative = pid_fixed_saturate((pid_fixed_mul(pid->derivative, pid->d_decay) >> PIDFIXED_GAIN_FRAC_BITS) -
+                                             pid_fixed_mul(delta_measurement, pid->d_gain),
+                                         INT32_MIN, INT32_MAX);
+    pid->prev_measurement = measurement;
+
+    const int64_t increment = pid_fixed_mul(error, pid->ki_dt);
+    int64_t output;
+    int32_t saturated;
+
+    if (pid->antiwindup == PIDFIXED_ANTIWINDUP_BACK_CALCULATION) {
+        /* 反馈计算: 积分按饱和量回退 */
+        output = proportional + pid->integral + pid->derivative;
+        saturated = pid_fixed_saturate(output, pid->output_min, pid->output_max);
+
+        /* 饱和量以64位计算, 再限制到32位后乘以增益 */
+        const int32_t excess = pid_fixed_saturate((int64_t)saturated - output, INT32_MIN, INT32_MAX);
+        const int64_t back = pid_fixed_mul(excess, pid->kb_dt) >> PIDFIXED_GAIN_FRAC_BITS;
+        pid->integral = pid_fixed_saturate(pid->integral + increment + back, pid->output_min, pid->output_max);
+    } else {
+        /* 钳位: 积分后输出饱和且误差与饱和方向相同时, 放弃本次积分 */
+        const int32_t integral = pid_fixed_saturate(pid->integral + increment, pid->output_min, pid->output_max);
+
+        output = proportional + integral + pid->derivative;
+        if (!((output > pid->output_max && error > 0) || (output < pid->output_min && error < 0))) {
+            pid->integral = integral;
+        } else {
+            output = proportional + pid->integral + pid->derivative;
+        }
+        saturated = pid_fixed_saturate(output, pid->output_min, pid->output_max);
+    }
+
+    pid->pid_output = q31_to_q15(saturated);
+
+    return pid->pid_output;
+}
+
+/* 获取PID输出 */
+int16_t pid_fixed_get_output(const struct pid_fixed *const pid) {
+    return pid->pid_output;
+}